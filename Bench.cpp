@@ -0,0 +1,267 @@
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include "Commands.h"
+#include "DisplayBuffer.h"
+#include "Gene.h"
+#include "Random.h"
+#include "World.h"
+#include "WorldFrame.h"
+
+//       .  ,  
+//         
+
+#define BENCH_SEED				1
+
+struct BenchOptions
+{
+	unsigned threads = 1;
+	//      
+	double minSeconds = 1.0;
+	//  ,    
+	const char* filter = nullptr;
+};
+
+static BenchOptions options;
+
+static void printUsage(const char* program)
+{
+	printf(
+		"Usage: %s [options]\n"
+		"  -t, --threads <n>    worker threads for world steps, 0 - all cores (default 1)\n"
+		"  -m, --min-time <f>   minimal duration of one measurement in seconds (default 1)\n"
+		"  -f, --filter <text>  run only benchmarks whose name contains text\n"
+		"  -h, --help           show this help\n",
+		program
+	);
+}
+
+static bool parseOptions(int argc, char** argv)
+{
+	for (int i = 1; i < argc; i++) {
+		const char* arg = argv[i];
+		if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) {
+			printUsage(argv[0]);
+			exit(0);
+		}
+
+		if (i + 1 >= argc) {
+			fprintf(stderr, "Missing value for option %s\n", arg);
+			return false;
+		}
+		const char* value = argv[++i];
+
+		if (strcmp(arg, "-t") == 0 || strcmp(arg, "--threads") == 0)
+			options.threads = static_cast<unsigned>(strtoul(value, nullptr, 10));
+		else if (strcmp(arg, "-m") == 0 || strcmp(arg, "--min-time") == 0)
+			options.minSeconds = atof(value);
+		else if (strcmp(arg, "-f") == 0 || strcmp(arg, "--filter") == 0)
+			options.filter = value;
+		else {
+			fprintf(stderr, "Unknown option %s\n", arg);
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool isSelected(const std::string& name)
+{
+	return options.filter == nullptr || name.find(options.filter) != std::string::npos;
+}
+
+//  ,      ,      .
+//   ,   ,       
+static void measure(const std::string& name, double unitsPerIteration, const char* unitName, const char* iterationName,
+	const std::function<double()>& iteration)
+{
+	double seconds = 0.0;
+	uint64_t iterations = 0;
+	while (seconds < options.minSeconds || iterations < 3) {
+		seconds += iteration();
+		iterations++;
+	}
+
+	double nsPerUnit = seconds * 1e9 / (iterations * unitsPerIteration);
+	double iterationsPerSecond = seconds > 0.0 ? iterations / seconds : 0.0;
+	printf("%-36s %10.2f ns/%-5s %12.1f %s/sec\n", name.c_str(), nsPerUnit, unitName, iterationsPerSecond, iterationName);
+	fflush(stdout);
+}
+
+static double elapsed(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static std::unique_ptr<World> createWorld(int width, int height, float density)
+{
+	auto world = std::make_unique<World>(static_cast<uint16_t>(width), static_cast<uint16_t>(height));
+	world->populationDensity = density;
+	world->seed(BENCH_SEED);
+	world->regenerate();
+	world->setThreadsCount(options.threads);
+	return world;
+}
+
+//   .          
+static void measureSteps(const std::string& name, World& world, int warmupSteps)
+{
+	if (!isSelected(name))
+		return;
+	for (int i = 0; i < warmupSteps; i++)
+		world.update();
+
+	double tilesCount = static_cast<double>(world.getWidth()) * world.getHeight();
+	measure(name, tilesCount, "tile", "steps", [&]() {
+		auto start = std::chrono::steady_clock::now();
+		world.update();
+		return elapsed(start);
+	});
+}
+
+//        
+static void benchWorldSteps()
+{
+	const int sizes[] = { 256, 1024, 2048 };
+	const float densities[] = { 0.01f, 0.1f, 0.5f };
+	for (int size : sizes) {
+		for (float density : densities) {
+			std::string name = "step/" + std::to_string(size) + "x" + std::to_string(size) + "/" + std::to_string(density).substr(0, 4);
+			if (!isSelected(name))
+				continue;
+			auto world = createWorld(size, size, density);
+			measureSteps(name, *world, 20);
+		}
+	}
+}
+
+//  ,   .       ,
+//         
+static void benchCommands()
+{
+	for (uint8_t command = 0; command < COMMANDS_COUNT; command++) {
+		std::string name = std::string("command/") + COMMANDS_NAMES[command];
+		if (!isSelected(name))
+			continue;
+		auto world = createWorld(512, 512, 0.5f);
+		world->energySpending = 0.0f;
+		world->moveEnergy = 0.0f;
+		world->reproductionEnergy = FLT_MAX;
+		for (uint8_t i = 0; i < GENE_COMMANDS_COUNT; i++)
+			world->setGeneCommand(1, i, command);
+		measureSteps(name, *world, 5);
+	}
+}
+
+//         
+static void benchReproduction()
+{
+	std::string name = "reproduction";
+	if (!isSelected(name))
+		return;
+	auto world = createWorld(512, 512, 0.1f);
+	world->energySpending = 0.0f;
+	world->reproductionEnergy = 0.0f;
+	world->mutationChance = 0.0f;
+	measureSteps(name, *world, 5);
+}
+
+//    :     ,     
+static void benchMutations()
+{
+	std::string name = "step/mutations";
+	if (!isSelected(name))
+		return;
+	auto world = createWorld(512, 512, 0.1f);
+	world->mutationChance = 1.0f;
+	//   ,   ,    
+	StatsHistory& history = world->getStatsHistory();
+	for (int i = 0; i < 1000 && (history.getCount() == 0 || history.getLast().birthsCount == 0); i++)
+		world->update();
+	measureSteps(name, *world, 20);
+}
+
+//   .   ,       
+static void benchGenes()
+{
+	const int batchSize = 60000;
+	auto world = createWorld(16, 16, 0.5f);
+
+	if (isSelected("gene/add")) {
+		measure("gene/add", batchSize, "gene", "batches", [&]() {
+			world->regenerate();
+			auto start = std::chrono::steady_clock::now();
+			for (int i = 0; i < batchSize; i++)
+				world->addGene(1);
+			return elapsed(start);
+		});
+	}
+
+	if (isSelected("gene/mutate")) {
+		measure("gene/mutate", batchSize, "gene", "batches", [&]() {
+			world->regenerate();
+			Gene* gene = world->getGene(1);
+			Random random(BENCH_SEED, 0, 0, Random::STREAM_STEP);
+			auto start = std::chrono::steady_clock::now();
+			for (int i = 0; i < batchSize; i++)
+				gene->mutate(*world, random);
+			return elapsed(start);
+		});
+	}
+}
+
+//    :      
+static void benchRendering()
+{
+	const int size = 1024;
+	double tilesCount = static_cast<double>(size) * size;
+	auto world = createWorld(size, size, 0.1f);
+	for (int i = 0; i < 20; i++)
+		world->update();
+
+	WorldFrame frame;
+	if (isSelected("render/capture")) {
+		measure("render/capture", tilesCount, "tile", "frames", [&]() {
+			//       
+			WorldFrame fullFrame;
+			auto start = std::chrono::steady_clock::now();
+			fullFrame.capture(*world);
+			return elapsed(start);
+		});
+	}
+
+	frame.capture(*world);
+	for (int mode = 0; mode < DISPLAY_MODES_COUNT; mode++) {
+		std::string name = std::string("render/") + DISPLAY_MODES_STRINGS[mode];
+		if (!isSelected(name))
+			continue;
+		DisplayBuffer displayBuffer;
+		measure(name, tilesCount, "tile", "frames", [&]() {
+			displayBuffer.invalidate();
+			auto start = std::chrono::steady_clock::now();
+			displayBuffer.update(frame, static_cast<DisplayMode>(mode), 0, 0, 0, size, size);
+			return elapsed(start);
+		});
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (!parseOptions(argc, argv)) {
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	benchWorldSteps();
+	benchCommands();
+	benchReproduction();
+	benchMutations();
+	benchGenes();
+	benchRendering();
+	return 0;
+}
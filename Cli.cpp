@@ -0,0 +1,284 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "World.h"
+#include "ReplayLog.h"
+#include "Snapshot.h"
+#include "SnapshotWriter.h"
+#include "StatsFile.h"
+#include "Trace.h"
+
+//     .       
+
+struct CliOptions
+{
+	int width = 512;
+	int height = 512;
+	uint32_t steps = 1000;
+	uint32_t seed = 0;
+	float populationDensity = -1.0f;
+	unsigned threads = 0;
+	//          
+	const char* loadPath = nullptr;
+	const char* savePath = nullptr;
+	//  ,   
+	std::vector<const char*> deltaPaths;
+	//   :      
+	const char* checkpointPrefix = nullptr;
+	uint32_t checkpointInterval = 0;
+	//   :   <prefix>.sim   <prefix>.log
+	const char* recordPrefix = nullptr;
+	// ,   ,  ,    
+	const char* replayPath = nullptr;
+	uint32_t replayToStep = UINT32_MAX;
+	//       
+	const char* tracePath = nullptr;
+	//         
+	const char* statsPath = nullptr;
+	uint32_t statsInterval = 0;
+};
+
+static void printUsage(const char* program)
+{
+	printf(
+		"Usage: %s [options]\n"
+		"  -W, --width <n>      world width (default 512)\n"
+		"  -H, --height <n>     world height (default 512)\n"
+		"  -n, --steps <n>      steps to simulate (default 1000)\n"
+		"  -s, --seed <n>       random seed (default 0)\n"
+		"  -d, --density <f>    initial population density\n"
+		"  -t, --threads <n>    worker threads, 0 - all cores (default 0)\n"
+		"  -i, --load <file>    load world from snapshot instead of generating it\n"
+		"  -o, --save <file>    save world snapshot after the run\n"
+		"  -a, --apply <file>   apply delta snapshot after loading, can be repeated\n"
+		"  -c, --checkpoint <prefix>    write <prefix>.base.sim and <prefix>.<step>.delta checkpoints\n"
+		"  -e, --checkpoint-every <n>   steps between delta checkpoints (default 100)\n"
+		"  -r, --record <prefix>        write <prefix>.sim and replay log <prefix>.log\n"
+		"  -p, --replay <file>          replay log after loading its base snapshot\n"
+		"  -u, --replay-to <step>       stop replaying at this step\n"
+		"  -T, --trace <file>           write Chrome trace of the run\n"
+		"  -S, --stats <file>           write per-step statistics, .csv as text, otherwise binary\n"
+		"  -E, --stats-every <n>        steps between statistics writes (default 100)\n"
+		"  -h, --help           show this help\n",
+		program
+	);
+}
+
+static bool parseOptions(int argc, char** argv, CliOptions& options)
+{
+	for (int i = 1; i < argc; i++) {
+		const char* arg = argv[i];
+		if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) {
+			printUsage(argv[0]);
+			exit(0);
+		}
+
+		if (i + 1 >= argc) {
+			fprintf(stderr, "Missing value for option %s\n", arg);
+			return false;
+		}
+		const char* value = argv[++i];
+
+		if (strcmp(arg, "-W") == 0 || strcmp(arg, "--width") == 0)
+			options.width = atoi(value);
+		else if (strcmp(arg, "-H") == 0 || strcmp(arg, "--height") == 0)
+			options.height = atoi(value);
+		else if (strcmp(arg, "-n") == 0 || strcmp(arg, "--steps") == 0)
+			options.steps = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+		else if (strcmp(arg, "-s") == 0 || strcmp(arg, "--seed") == 0)
+			options.seed = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+		else if (strcmp(arg, "-d") == 0 || strcmp(arg, "--density") == 0)
+			options.populationDensity = static_cast<float>(atof(value));
+		else if (strcmp(arg, "-t") == 0 || strcmp(arg, "--threads") == 0)
+			options.threads = static_cast<unsigned>(strtoul(value, nullptr, 10));
+		else if (strcmp(arg, "-i") == 0 || strcmp(arg, "--load") == 0)
+			options.loadPath = value;
+		else if (strcmp(arg, "-o") == 0 || strcmp(arg, "--save") == 0)
+			options.savePath = value;
+		else if (strcmp(arg, "-a") == 0 || strcmp(arg, "--apply") == 0)
+			options.deltaPaths.push_back(value);
+		else if (strcmp(arg, "-c") == 0 || strcmp(arg, "--checkpoint") == 0)
+			options.checkpointPrefix = value;
+		else if (strcmp(arg, "-e") == 0 || strcmp(arg, "--checkpoint-every") == 0)
+			options.checkpointInterval = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+		else if (strcmp(arg, "-r") == 0 || strcmp(arg, "--record") == 0)
+			options.recordPrefix = value;
+		else if (strcmp(arg, "-p") == 0 || strcmp(arg, "--replay") == 0)
+			options.replayPath = value;
+		else if (strcmp(arg, "-u") == 0 || strcmp(arg, "--replay-to") == 0)
+			options.replayToStep = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+		else if (strcmp(arg, "-T") == 0 || strcmp(arg, "--trace") == 0)
+			options.tracePath = value;
+		else if (strcmp(arg, "-S") == 0 || strcmp(arg, "--stats") == 0)
+			options.statsPath = value;
+		else if (strcmp(arg, "-E") == 0 || strcmp(arg, "--stats-every") == 0)
+			options.statsInterval = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+		else {
+			fprintf(stderr, "Unknown option %s\n", arg);
+			return false;
+		}
+	}
+
+	if (options.width <= 0 || options.width > UINT16_MAX || options.height <= 0 || options.height > UINT16_MAX) {
+		fprintf(stderr, "World size must be in range 1..%i\n", UINT16_MAX);
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	CliOptions options;
+	if (!parseOptions(argc, argv, options)) {
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	std::unique_ptr<World> worldPtr;
+	if (options.loadPath != nullptr) {
+		auto start = std::chrono::steady_clock::now();
+		worldPtr = Snapshot::load(options.loadPath);
+		if (!worldPtr) {
+			fprintf(stderr, "Failed to load snapshot %s\n", options.loadPath);
+			return 1;
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		printf("Loaded %s in %.3f s\n", options.loadPath, seconds);
+	} else {
+		worldPtr = std::make_unique<World>(static_cast<uint16_t>(options.width), static_cast<uint16_t>(options.height));
+		if (options.populationDensity >= 0.0f)
+			worldPtr->populationDensity = options.populationDensity;
+		worldPtr->seed(options.seed);
+		worldPtr->regenerate();
+	}
+	World& world = *worldPtr;
+	world.setThreadsCount(options.threads);
+
+	for (const char* deltaPath : options.deltaPaths) {
+		if (!Snapshot::applyDelta(world, deltaPath)) {
+			fprintf(stderr, "Failed to apply delta snapshot %s\n", deltaPath);
+			return 1;
+		}
+	}
+
+	if (options.replayPath != nullptr) {
+		auto start = std::chrono::steady_clock::now();
+		if (!ReplayLog::play(world, options.replayPath, options.replayToStep)) {
+			fprintf(stderr, "Failed to replay %s\n", options.replayPath);
+			return 1;
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		printf("Replayed %s to step %i in %.3f s\n", options.replayPath, world.getStepsCount(), seconds);
+	}
+
+	ReplayLog replayLog;
+	if (options.recordPrefix != nullptr) {
+		std::string prefix = options.recordPrefix;
+		if (!Snapshot::save(world, prefix + ".sim") || !replayLog.open(world, prefix + ".log")) {
+			fprintf(stderr, "Failed to start recording %s\n", options.recordPrefix);
+			return 1;
+		}
+	}
+
+	//            statsInterval .
+	//   STATS_HISTORY_SIZE ,    
+	StatsFile statsFile;
+	uint32_t statsInterval = options.statsInterval > 0 ? std::min<uint32_t>(options.statsInterval, STATS_HISTORY_SIZE) : 100;
+	if (options.statsPath != nullptr) {
+		if (!statsFile.open(world.getStatsHistory(), options.statsPath)) {
+			fprintf(stderr, "Failed to create statistics file %s\n", options.statsPath);
+			return 1;
+		}
+		world.countLifeForms = true;
+	}
+
+	Trace::setThreadName("Main");
+	if (options.tracePath != nullptr)
+		Trace::start();
+
+	//     ,      
+	SnapshotWriter checkpointWriter;
+	double checkpointCaptureSeconds = 0.0;
+	unsigned checkpointsCount = 0;
+	uint32_t checkpointInterval = options.checkpointInterval > 0 ? options.checkpointInterval : 100;
+	uint32_t checkpointStep = world.getStepsCount();
+	uint32_t checkpointEpoch = world.beginChangeEpoch();
+	if (options.checkpointPrefix != nullptr)
+		checkpointWriter.write(Snapshot::capture(world), std::string(options.checkpointPrefix) + ".base.sim");
+
+	auto start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < options.steps; i++) {
+		replayLog.update(world);
+
+		if (statsFile.isOpened() && (i + 1) % statsInterval == 0 && !statsFile.write(world.getStatsHistory())) {
+			fprintf(stderr, "Failed to write statistics file %s\n", options.statsPath);
+			return 1;
+		}
+
+		if (options.checkpointPrefix != nullptr && (i + 1) % checkpointInterval == 0) {
+			std::string path = std::string(options.checkpointPrefix) + "." + std::to_string(world.getStepsCount()) + ".delta";
+			auto captureStart = std::chrono::steady_clock::now();
+			uint32_t epoch = world.beginChangeEpoch();
+			auto buffer = Snapshot::captureDelta(world, checkpointStep, checkpointEpoch);
+			checkpointCaptureSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - captureStart).count();
+			checkpointsCount++;
+			checkpointWriter.write(std::move(buffer), path);
+			checkpointStep = world.getStepsCount();
+			checkpointEpoch = epoch;
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+	replayLog.close(world);
+
+	if (statsFile.isOpened()) {
+		if (!statsFile.write(world.getStatsHistory())) {
+			fprintf(stderr, "Failed to write statistics file %s\n", options.statsPath);
+			return 1;
+		}
+		statsFile.close();
+	}
+
+	if (options.tracePath != nullptr) {
+		//    ,     
+		checkpointWriter.flush();
+		if (!Trace::stop(options.tracePath)) {
+			fprintf(stderr, "Failed to write trace %s\n", options.tracePath);
+			return 1;
+		}
+	}
+
+	double seconds = std::chrono::duration<double>(end - start).count();
+	double stepsPerSecond = seconds > 0.0 ? options.steps / seconds : 0.0;
+
+	printf("World: %ix%i, seed %u, threads %u\n", world.getWidth(), world.getHeight(), world.getSeed(), world.getThreadsCount());
+	printf("Steps: %u in %.3f s (%.1f steps/sec)\n", options.steps, seconds, stepsPerSecond);
+	printf("Alive tiles: %u\n", world.getAliveTilesCount());
+	printf("Genes: %u\n", world.getUsedGenesCount());
+	printf("Checksum: %016llx\n", static_cast<unsigned long long>(world.getChecksum()));
+
+	if (options.checkpointPrefix != nullptr) {
+		checkpointWriter.flush();
+		if (checkpointWriter.getFailedCount() > 0) {
+			fprintf(stderr, "Failed to write %u checkpoints with prefix %s\n", checkpointWriter.getFailedCount(), options.checkpointPrefix);
+			return 1;
+		}
+		if (checkpointsCount > 0)
+			printf("Checkpoints: %u, capture %.3f ms each\n", checkpointsCount, checkpointCaptureSeconds * 1000.0 / checkpointsCount);
+	}
+
+	if (options.savePath != nullptr) {
+		auto start = std::chrono::steady_clock::now();
+		if (!Snapshot::save(world, options.savePath)) {
+			fprintf(stderr, "Failed to save snapshot %s\n", options.savePath);
+			return 1;
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		printf("Saved %s in %.3f s\n", options.savePath, seconds);
+	}
+
+	return 0;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdint.h>
+
+//    RGBA.    SFML,      
+struct Color
+{
+	uint8_t r = 0;
+	uint8_t g = 0;
+	uint8_t b = 0;
+	uint8_t a = 255;
+
+	constexpr Color() {}
+
+	constexpr Color(uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha = 255) :
+		r(red), g(green), b(blue), a(alpha) {}
+
+	//      0xRRGGBBAA
+	constexpr explicit Color(uint32_t rgba) :
+		r(static_cast<uint8_t>(rgba >> 24)),
+		g(static_cast<uint8_t>(rgba >> 16)),
+		b(static_cast<uint8_t>(rgba >> 8)),
+		a(static_cast<uint8_t>(rgba)) {}
+
+	bool operator==(const Color& other) const {
+		return r == other.r && g == other.g && b == other.b && a == other.a;
+	}
+
+	bool operator!=(const Color& other) const {
+		return !(*this == other);
+	}
+};
@@ -22,4 +22,4 @@
 #define COMMANDS_COUNT			5
 
 //    
-const char* COMMANDS_NAMES[];
+extern const char* COMMANDS_NAMES[];
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <SFML/Graphics.hpp>
+#include "Color.h"
 
 #define SIMULATION_VERSION		"0.1"
 
@@ -26,12 +26,18 @@
 #define SIMULATION_HEIGHT		500
 #define SIMULATION_STEP_TIME	0.1f
 
+//      
+#define WORLD_BLOCK_WIDTH		64
+#define WORLD_BLOCK_HEIGHT		16
+
 #define GENE_COMMANDS_COUNT		32
 #define MAX_MUTATIONS_COUNT		8
-
-const sf::Color BACKGROUND_COLOR = sf::Color(0x323232FF);
-const sf::Color FOOD_COLOR = sf::Color(0xFFBC00FF);
-const sf::Color PLANTS_COLOR = sf::Color::Green;
-const sf::Color PREDATOR_COLOR = sf::Color::Red;
-const sf::Color GRID_COLOR = sf::Color(0x626262FF);
-const sf::Color SELECTION_COLOR = sf::Color::White;
+//   16-,   0   
+#define MAX_GENES_COUNT			65535
+
+const Color BACKGROUND_COLOR = Color(0x323232FFu);
+const Color FOOD_COLOR = Color(0xFFBC00FFu);
+const Color PLANTS_COLOR = Color(0, 255, 0);
+const Color PREDATOR_COLOR = Color(255, 0, 0);
+const Color GRID_COLOR = Color(0x626262FFu);
+const Color SELECTION_COLOR = Color(255, 255, 255);
@@ -0,0 +1,297 @@
+#include <algorithm>
+#include "Config.h"
+#include "Utils.h"
+#include "WorldFrame.h"
+#include "DisplayBuffer.h"
+
+static_assert(sizeof(Color) == 4, "Color must be a packed RGBA pixel");
+
+const char* DISPLAY_MODES_STRINGS[] = {
+	"Energy", "Life forms", "Species"
+};
+
+//      .    ,   
+//    .      
+static Color voteColors(const Color* colors, int count)
+{
+	const Color emptyColor = Color(0, 0, 0);
+	Color best = emptyColor;
+	int bestCount = 0;
+	for (int i = 0; i < count; i++) {
+		if (colors[i] == emptyColor)
+			continue;
+		int sameCount = 0;
+		for (int k = i; k < count; k++) {
+			if (colors[k] == colors[i])
+				sameCount++;
+		}
+		if (sameCount > bestCount) {
+			best = colors[i];
+			bestCount = sameCount;
+		}
+	}
+	return best;
+}
+
+//   . energyScale - ,   
+template<DisplayMode displayMode>
+static Color getTileColor(const WorldFrame& frame, float energyScale, size_t index)
+{
+	if (displayMode == DISPLAY_MODE_ENERGY)
+		return Utils::mixColors(Color(0, 0, 255), Color(255, 0, 0), frame.energy[index] * energyScale);
+	uint16_t geneIndex = frame.geneIndex[index];
+	if (displayMode == DISPLAY_MODE_LIFE_FORMS) {
+		if (geneIndex != 0)
+			return frame.isPredator[index] ? PREDATOR_COLOR : PLANTS_COLOR;
+		return frame.energy[index] > 0.0f ? FOOD_COLOR : Color(0, 0, 0);
+	}
+	return geneIndex < frame.geneColors.size() ? frame.geneColors[geneIndex] : Color(0, 0, 0);
+}
+
+//    begin  end,   end
+template<DisplayMode displayMode>
+static void getTileColors(const WorldFrame& frame, float energyScale, size_t begin, size_t end, Color* colors)
+{
+	for (size_t i = begin; i < end; i++)
+		*colors++ = getTileColor<displayMode>(frame, energyScale, i);
+}
+
+void DisplayBuffer::update(WorldFrame& frame, DisplayMode displayMode, int level, int left, int top, int width, int height)
+{
+	//     
+	if (frame.width != _worldWidth || frame.height != _worldHeight) {
+		_worldWidth = frame.width;
+		_worldHeight = frame.height;
+		_levels.clear();
+		_dirtyCells.clear();
+		_isValid = false;
+	}
+
+	//                 .
+	//   ,       
+	bool isFull = !_isValid || frame.epoch < _markedEpoch || displayMode != _displayMode ||
+		(displayMode == DISPLAY_MODE_ENERGY && frame.energyMaximum != _energyMaximum) ||
+		(displayMode == DISPLAY_MODE_SPECIES && frame.geneColorsEpoch > _geneColorsEpoch);
+	if (isFull) {
+		_displayMode = displayMode;
+		_energyMaximum = frame.energyMaximum;
+		_energyScale = frame.energyMaximum > 0.0f ? 1.0f / frame.energyMaximum : 0.0f;
+		_geneColorsEpoch = frame.geneColorsEpoch;
+		_chunkEpochs.assign(frame.chunkEpochs.size(), 0);
+		for (auto& dirtyCells : _dirtyCells)
+			std::fill(dirtyCells.begin(), dirtyCells.end(), 1);
+		_isValid = true;
+	}
+
+	//     .     ,     ,
+	//    ,     - 
+	if (_levels.empty()) {
+		_levels.emplace_back();
+		_dirtyCells.emplace_back();
+	}
+	while (static_cast<int>(_levels.size()) <= level) {
+		int newLevel = static_cast<int>(_levels.size());
+		size_t count = static_cast<size_t>(getLevelSize(_worldWidth, newLevel)) * getLevelSize(_worldHeight, newLevel);
+		_levels.emplace_back(count);
+		_dirtyCells.emplace_back(count, 1);
+	}
+
+	bool isRegionChanged = isFull || level != _level || left != _left || top != _top || width != _width || height != _height;
+	_level = level;
+	_left = left;
+	_top = top;
+	_width = width;
+	_height = height;
+	_pixels.resize(static_cast<size_t>(width) * height);
+	_dirtyTop = isRegionChanged ? 0 : height;
+	_dirtyBottom = isRegionChanged ? height : 0;
+
+	//       ,    .
+	//     ,      ,     
+	if (!isFull && _levels.size() > 1) {
+		for (size_t group = 0; group < frame.chunkGroupEpochs.size(); group++) {
+			if (frame.chunkGroupEpochs[group] <= _markedEpoch)
+				continue;
+			size_t end = std::min((group + 1) * WorldFrame::CHUNK_GROUP_SIZE, frame.chunkEpochs.size());
+			for (size_t chunk = group * WorldFrame::CHUNK_GROUP_SIZE; chunk < end; chunk++) {
+				if (frame.chunkEpochs[chunk] > _markedEpoch)
+					markChunk(chunk);
+			}
+		}
+	}
+	_markedEpoch = frame.epoch;
+
+	//      ,       
+	if (level == 0) {
+		if (_levels[0].empty())
+			_levels[0].resize(static_cast<size_t>(_worldWidth) * _worldHeight);
+		int right = std::min(_worldWidth, left + width);
+		int bottom = std::min(_worldHeight, top + height);
+		for (int y = top; y < bottom; y++) {
+			size_t begin = static_cast<size_t>(y) * _worldWidth + left;
+			size_t end = static_cast<size_t>(y) * _worldWidth + right;
+			for (size_t chunk = begin / WorldFrame::CHUNK_SIZE; chunk <= (end - 1) / WorldFrame::CHUNK_SIZE; chunk++) {
+				if (_chunkEpochs[chunk] > frame.chunkEpochs[chunk])
+					continue;
+				updateChunk(frame, chunk);
+
+				//     
+				int firstRow = static_cast<int>(chunk * WorldFrame::CHUNK_SIZE / _worldWidth) - top;
+				size_t lastTile = std::min(chunk * WorldFrame::CHUNK_SIZE + WorldFrame::CHUNK_SIZE, frame.energy.size()) - 1;
+				int lastRow = static_cast<int>(lastTile / _worldWidth) - top;
+				_dirtyTop = std::min(_dirtyTop, std::max(firstRow, 0));
+				_dirtyBottom = std::max(_dirtyBottom, std::min(lastRow + 1, height));
+			}
+		}
+	}
+
+	//       
+	if (level > 0) {
+		int levelWidth = getLevelSize(_worldWidth, level);
+		for (int y = 0; y < height; y++) {
+			const uint8_t* dirtyCells = _dirtyCells[level].data() + static_cast<size_t>(top + y) * levelWidth + left;
+			bool isRowChanged = false;
+			for (int x = 0; x < width; x++) {
+				if (dirtyCells[x]) {
+					updateCell(frame, level, left + x, top + y);
+					isRowChanged = true;
+				}
+			}
+			if (isRowChanged) {
+				_dirtyTop = std::min(_dirtyTop, y);
+				_dirtyBottom = std::max(_dirtyBottom, y + 1);
+			}
+		}
+	}
+
+	//      
+	int levelWidth = getLevelSize(_worldWidth, level);
+	for (int y = _dirtyTop; y < _dirtyBottom; y++) {
+		const Color* cells = _levels[level].data() + static_cast<size_t>(top + y) * levelWidth + left;
+		std::copy(cells, cells + width, _pixels.data() + static_cast<size_t>(y) * width);
+	}
+}
+
+void DisplayBuffer::invalidate()
+{
+	_isValid = false;
+}
+
+const uint8_t* DisplayBuffer::getPixels()
+{
+	return reinterpret_cast<const uint8_t*>(_pixels.data());
+}
+
+int DisplayBuffer::getWidth()
+{
+	return _width;
+}
+
+int DisplayBuffer::getHeight()
+{
+	return _height;
+}
+
+int DisplayBuffer::getDirtyTop()
+{
+	return _dirtyTop;
+}
+
+int DisplayBuffer::getDirtyBottom()
+{
+	return _dirtyBottom;
+}
+
+int DisplayBuffer::getLevelSize(int size, int level)
+{
+	return static_cast<int>((static_cast<int64_t>(size) + (1 << level) - 1) >> level);
+}
+
+void DisplayBuffer::updateChunk(WorldFrame& frame, size_t chunk)
+{
+	size_t begin = chunk * WorldFrame::CHUNK_SIZE;
+	size_t end = std::min(begin + WorldFrame::CHUNK_SIZE, frame.energy.size());
+	_chunkEpochs[chunk] = frame.chunkEpochs[chunk] + 1;
+
+	getTileColors(frame, begin, end, _levels[0].data() + begin);
+}
+
+void DisplayBuffer::markChunk(size_t chunk)
+{
+	//          
+	size_t begin = chunk * WorldFrame::CHUNK_SIZE;
+	size_t end = std::min(begin + WorldFrame::CHUNK_SIZE, static_cast<size_t>(_worldWidth) * _worldHeight);
+	for (size_t i = begin; i < end;) {
+		int y = static_cast<int>(i / _worldWidth);
+		int x = static_cast<int>(i % _worldWidth);
+		size_t rowEnd = std::min(end, static_cast<size_t>(y + 1) * _worldWidth);
+		markCells(y, x, x + static_cast<int>(rowEnd - i) - 1);
+		i = rowEnd;
+	}
+}
+
+void DisplayBuffer::updateCell(WorldFrame& frame, int level, int x, int y)
+{
+	int childWidth = getLevelSize(_worldWidth, level - 1);
+	int childHeight = getLevelSize(_worldHeight, level - 1);
+	int childX = x * 2;
+	int childY = y * 2;
+	int countX = std::min(2, childWidth - childX);
+	int countY = std::min(2, childHeight - childY);
+
+	//         .       
+	Color colors[4];
+	int count = 0;
+	for (int i = 0; i < countY; i++) {
+		size_t index = static_cast<size_t>(childY + i) * childWidth + childX;
+		if (level == 1) {
+			getTileColors(frame, index, index + countX, colors + count);
+		} else {
+			for (int k = 0; k < countX; k++) {
+				if (_dirtyCells[level - 1][index + k])
+					updateCell(frame, level - 1, childX + k, childY + i);
+				colors[count + k] = _levels[level - 1][index + k];
+			}
+		}
+		count += countX;
+	}
+
+	size_t index = static_cast<size_t>(y) * getLevelSize(_worldWidth, level) + x;
+	if (_displayMode == DISPLAY_MODE_SPECIES) {
+		_levels[level][index] = voteColors(colors, count);
+	} else {
+		unsigned r = 0;
+		unsigned g = 0;
+		unsigned b = 0;
+		for (int i = 0; i < count; i++) {
+			r += colors[i].r;
+			g += colors[i].g;
+			b += colors[i].b;
+		}
+		_levels[level][index] = Color(static_cast<uint8_t>(r / count), static_cast<uint8_t>(g / count), static_cast<uint8_t>(b / count));
+	}
+	_dirtyCells[level][index] = 0;
+}
+
+void DisplayBuffer::getTileColors(WorldFrame& frame, size_t begin, size_t end, Color* colors)
+{
+	switch (_displayMode) {
+	case DISPLAY_MODE_ENERGY:
+		::getTileColors<DISPLAY_MODE_ENERGY>(frame, _energyScale, begin, end, colors);
+		break;
+	case DISPLAY_MODE_LIFE_FORMS:
+		::getTileColors<DISPLAY_MODE_LIFE_FORMS>(frame, _energyScale, begin, end, colors);
+		break;
+	default:
+		::getTileColors<DISPLAY_MODE_SPECIES>(frame, _energyScale, begin, end, colors);
+		break;
+	}
+}
+
+void DisplayBuffer::markCells(int y, int x0, int x1)
+{
+	for (int level = 1; level < static_cast<int>(_levels.size()); level++) {
+		uint8_t* dirtyCells = _dirtyCells[level].data() + static_cast<size_t>(y >> level) * getLevelSize(_worldWidth, level);
+		std::fill(dirtyCells + (x0 >> level), dirtyCells + (x1 >> level) + 1, static_cast<uint8_t>(1));
+	}
+}
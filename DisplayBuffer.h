@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include "Color.h"
+
+class WorldFrame;
+
+//   
+enum DisplayMode {
+	DISPLAY_MODE_ENERGY, DISPLAY_MODE_LIFE_FORMS, DISPLAY_MODE_SPECIES, DISPLAY_MODES_COUNT
+};
+
+//     
+extern const char* DISPLAY_MODES_STRINGS[];
+
+//         .      RGBA
+//  ,   level -   2^level x 2^level .  
+//    -      ,   -    .
+//       ,       .
+//     ,    ,   
+//    ,         .        ,    ,
+//         .    SFML,     
+class DisplayBuffer
+{
+public:
+	//    level     (left, top).
+	//      , . getLevelSize
+	void update(WorldFrame& frame, DisplayMode displayMode, int level, int left, int top, int width, int height);
+	//  ,      
+	void invalidate();
+
+	const uint8_t* getPixels();
+	int getWidth();
+	int getHeight();
+	//  ,   ,  dirtyTop  dirtyBottom,   dirtyBottom
+	int getDirtyTop();
+	int getDirtyBottom();
+
+	//    level     size
+	static int getLevelSize(int size, int level);
+
+private:
+	//    
+	std::vector<Color> _pixels;
+	int _level = 0;
+	int _left = 0;
+	int _top = 0;
+	int _width = 0;
+	int _height = 0;
+	int _dirtyTop = 0;
+	int _dirtyBottom = 0;
+
+	//      .     ,   
+	std::vector<std::vector<Color>> _levels;
+	//    ,   
+	std::vector<std::vector<uint8_t>> _dirtyCells;
+	//    ,       ,  1. 0 -   
+	std::vector<uint32_t> _chunkEpochs;
+	//   ,       
+	uint32_t _markedEpoch = 0;
+	int _worldWidth = 0;
+	int _worldHeight = 0;
+
+	//   .      
+	bool _isValid = false;
+	DisplayMode _displayMode = DISPLAY_MODE_LIFE_FORMS;
+	float _energyMaximum = 0.0f;
+	float _energyScale = 0.0f;
+	uint32_t _geneColorsEpoch = 0;
+
+	//     
+	void updateChunk(WorldFrame& frame, size_t chunk);
+	//      
+	void markChunk(size_t chunk);
+	//    level        
+	void updateCell(WorldFrame& frame, int level, int x, int y);
+	//     begin  end,   end,    
+	void getTileColors(WorldFrame& frame, size_t begin, size_t end, Color* colors);
+	//        y  x0  x1 
+	void markCells(int y, int x0, int x1);
+};
\ No newline at end of file
@@ -1,22 +1,33 @@
-#include <random>
+#include <string.h>
 #include "Config.h"
-#include "Main.h"
+#include "Random.h"
 #include "World.h"
 #include "Utils.h"
 #include "Gene.h"
 
-Gene::Gene(uint16_t index, uint16_t parentIndex=0)
+Gene::Gene()
+{
+    _index = 0;
+    _parentIndex = 0;
+    _mutationsCount = 0;
+}
+
+void Gene::init(uint16_t index, uint16_t parentIndex)
 {
-    _commands = new uint8_t[GENE_COMMANDS_COUNT];
     _index = index;
     _parentIndex = parentIndex;
     _mutationsCount = 0;
-    color = Utils::hsvToRgb(Main::randomFloat() * 255.0f, 1.0f, 255.0f);
+    referenceCount = 0;
+}
+
+void Gene::release()
+{
+    _index = 0;
 }
 
-Gene::~Gene()
+bool Gene::isUsed()
 {
-    delete[] _commands;
+    return _index != 0;
 }
 
 uint8_t Gene::getCommand(uint8_t num)
@@ -40,23 +51,22 @@ uint16_t Gene::getParentIndex()
     return _parentIndex;
 }
 
-uint16_t Gene::mutate(World& world)
+uint16_t Gene::mutate(World& world, Random& random)
 {
-    static std::uniform_int_distribution<int> indexDistribution(0, GENE_COMMANDS_COUNT - 1);
-    static std::uniform_int_distribution<int> opcodeDistribution(0, GENE_COMMANDS_COUNT + COMMANDS_COUNT);
+    uint8_t index = static_cast<uint8_t>(random.nextInt(GENE_COMMANDS_COUNT));
+    uint8_t command = static_cast<uint8_t>(random.nextInt(GENE_COMMANDS_COUNT + COMMANDS_COUNT + 1));
 
-    uint8_t index = indexDistribution(Main::getRandomGenerator());
-    uint8_t command = opcodeDistribution(Main::getRandomGenerator());
+    Gene* gene = world.addGene(_mutationsCount < MAX_MUTATIONS_COUNT ? _parentIndex : _index);
 
-    Gene* gene;
+    //    ,     
+    if (gene == nullptr)
+        return _index;
 
     if (_mutationsCount < MAX_MUTATIONS_COUNT) {
-        gene = world.addGene(_parentIndex);
         gene->color = color;
         gene->_mutationsCount = _mutationsCount + 1;
     } else {
-        gene = world.addGene(_index);
-        gene->color = Utils::hsvToRgb(Main::randomFloat() * 255.0f, 1.0f, 255.0f);
+        gene->color = Utils::hsvToRgb(random.nextFloat() * 255.0f, 1.0f, 255.0f);
         gene->_mutationsCount = 0;
     }
     memcpy(gene->_commands, _commands, GENE_COMMANDS_COUNT);
@@ -1,23 +1,34 @@
 #pragma once
 
 #include <stdint.h>
-#include <random>
-#include <SFML/Graphics.hpp>
+#include <atomic>
+#include "Color.h"
+#include "Config.h"
 #include "Commands.h"
 
 class World;
+class Random;
 
+//     ,      ,
+//       
 class Gene
 {
+	friend class Snapshot;
+
 public:
-	Gene(uint16_t index, uint16_t parentIndex);
-	~Gene();
+	Gene();
+
+	//      
+	void init(uint16_t index, uint16_t parentIndex);
+	//   
+	void release();
+	bool isUsed();
 
 	//     
-	uint32_t referenceCount = 0;
+	std::atomic<uint32_t> referenceCount = { 0 };
 
 	//   
-	sf::Color color;
+	Color color;
 
 	uint8_t getCommand(uint8_t num);
 	void setCommand(uint8_t num, uint8_t command);
@@ -25,10 +36,10 @@ public:
 	uint16_t getParentIndex();
 
 	//   .    
-	uint16_t mutate(World& world);
+	uint16_t mutate(World& world, Random& random);
 
 private:
-	uint8_t* _commands;
+	uint8_t _commands[GENE_COMMANDS_COUNT];
 	uint16_t _index;
 	uint16_t _parentIndex;
 
@@ -1,3 +1,4 @@
+#include <stdio.h>
 #include <chrono>
 #include <SFML/Graphics.hpp>
 #include <imgui-SFML.h>
@@ -5,6 +6,12 @@
 #include "IconsMaterialDesign.h"
 #include "Config.h"
 #include "World.h"
+#include "WorldFrame.h"
+#include "SimulationThread.h"
+#include "Snapshot.h"
+#include "SnapshotWriter.h"
+#include "Trace.h"
+#include "WorldRenderer.h"
 #include "Commands.h"
 #include "Gene.h"
 #include "Utils.h"
@@ -12,9 +19,6 @@
 
 using namespace sf;
 
-std::minstd_rand0 Main::_randomGenerator;
-std::uniform_real_distribution<float> Main::_floatDistribution = std::uniform_real_distribution<float>(0.0f, 1.0f);
-
 RenderWindow* Main::_renderWindow = nullptr;
 RenderTexture Main::_renderTexture;
 Clock Main::_clock;
@@ -24,15 +28,33 @@ Vector2f Main::_mouseDelta;
 int Main::_scrollDelta = 0;
 
 World* Main::_currentWorld = nullptr;
-Clock Main::_stepClock;
+WorldRenderer* Main::_worldRenderer = nullptr;
+SimulationThread* Main::_simulation = nullptr;
+World* Main::_loadedWorld = nullptr;
 bool Main::_isPaused = true;
 bool Main::_skipStep = false;
 float Main::_playSpeed = 1.0f;
+bool Main::_isTurbo = false;
+int Main::_turboStepsPerFrame = 0;
+Profiler Main::_frameProfiler;
 
 Gene* Main::_editingGene = nullptr;
 ImFont* Main::_iconicFont = nullptr;
 bool Main::_isAboutWindowOpened = false;
 
+char Main::_statePath[256] = "world.sim";
+bool Main::_isStateWindowOpened = false;
+bool Main::_isStateSaving = false;
+bool Main::_hasStateError = false;
+SnapshotWriter* Main::_stateWriter = nullptr;
+std::shared_ptr<SnapshotBuffer> Main::_stateBuffer;
+unsigned Main::_stateFailedCount = 0;
+ReplayLog Main::_replayLog;
+char Main::_replayPath[256] = "replay";
+bool Main::_hasReplayError = false;
+char Main::_tracePath[256] = "trace.json";
+bool Main::_hasTraceError = false;
+
 int main(int argc, char** argv)
 {
 	Main::start();
@@ -59,20 +81,9 @@ int Main::getScrollDelta()
 	return _scrollDelta;
 }
 
-std::minstd_rand0& Main::getRandomGenerator()
-{
-	return _randomGenerator;
-}
-
-float Main::randomFloat()
-{
-	return _floatDistribution(_randomGenerator);
-}
-
 void Main::start()
 {
-	//    
-	_randomGenerator.seed(static_cast<unsigned int>(std::chrono::system_clock::now().time_since_epoch().count()));
+	Trace::setThreadName("Main");
 
 	//  
 	_renderWindow = new RenderWindow(VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT), WINDOW_NAME, Style::Close | Style::Titlebar);
@@ -96,7 +107,12 @@ void Main::start()
 	
 	//  
 	_currentWorld = new World(128, 128);
+	_currentWorld->setThreadsCount(0);
+	_currentWorld->seed(static_cast<uint32_t>(std::chrono::system_clock::now().time_since_epoch().count()));
 	_currentWorld->regenerate();
+	_worldRenderer = new WorldRenderer(*_currentWorld);
+	_stateWriter = new SnapshotWriter();
+	_simulation = new SimulationThread(*_currentWorld, _replayLog);
 
 	//  
 	while (_renderWindow->isOpen()) {
@@ -113,10 +129,15 @@ void Main::update()
 	Time dt = _clock.restart();
 	_timeDelta = dt.asSeconds();
 
+	//      ,     
+	_frameProfiler.add(PROFILER_FRAME, _timeDelta);
+	_frameProfiler.commit();
+
 	//  
 	_scrollDelta = 0;
 
 	//      
+	ProfilerScope eventsScope(_frameProfiler, PROFILER_FRAME_EVENTS);
 	Event event;
 	while (_renderWindow->pollEvent(event)) {
 		handleEvent(event);
@@ -126,26 +147,38 @@ void Main::update()
 	//   
 	_mouseDelta = Vector2f(Mouse::getPosition()) - _mousePos;
 	_mousePos = Vector2f(Mouse::getPosition());
+	eventsScope.stop();
 
-	//      
-	if (_skipStep || (!_isPaused && _stepClock.getElapsedTime().asSeconds() > SIMULATION_STEP_TIME / _playSpeed)) {
-		_stepClock.restart();
-		_currentWorld->update();
-	}
-	_skipStep = false;
-
-	//   
+	//    .     ,    
+	ProfilerScope worldScope(_frameProfiler, PROFILER_FRAME_WORLD);
 	_renderTexture.resetGLStates();
-	_renderTexture.clear(Color::Transparent);
-	_currentWorld->render(_renderTexture);
+	_renderTexture.clear(sf::Color::Transparent);
+	_worldRenderer->render(_renderTexture, _simulation->acquireFrame());
 	_renderTexture.display();
+	worldScope.stop();
 
-	//  
+	//  .     ,     
+	ProfilerScope lockScope(_frameProfiler, PROFILER_FRAME_LOCK);
+	_simulation->lockWorld();
+	lockScope.stop();
+	ProfilerScope guiScope(_frameProfiler, PROFILER_FRAME_GUI);
 	ImGui::SFML::Update(*_renderWindow, dt);
 	renderGUI();
+	_simulation->setPaused(_isPaused);
+	_simulation->setStepsPerSecond(_playSpeed / SIMULATION_STEP_TIME);
+	_simulation->setTurbo(_isTurbo, static_cast<uint32_t>(_turboStepsPerFrame));
+	if (_skipStep)
+		_simulation->requestStep();
+	_skipStep = false;
+	_simulation->unlockWorld();
 
-	//    
-	_renderWindow->clear(BACKGROUND_COLOR);
+	if (_loadedWorld != nullptr)
+		replaceWorld();
+	guiScope.stop();
+
+	//    .      
+	ProfilerScope displayScope(_frameProfiler, PROFILER_FRAME_DISPLAY);
+	_renderWindow->clear(toSfColor(BACKGROUND_COLOR));
 	ImGui::SFML::Render();
 	_renderWindow->display();
 }
@@ -166,7 +199,12 @@ void Main::handleEvent(sf::Event& event)
 void Main::release()
 {
 	ImGui::SFML::Shutdown();
+	delete _simulation;
+	_replayLog.close(*_currentWorld);
+	//  ,     
+	delete _stateWriter;
 	delete _renderWindow;
+	delete _worldRenderer;
 	delete _currentWorld;
 }
 
@@ -178,6 +216,7 @@ void Main::renderGUI()
 	renderSimulationWindow();
 	renderGeneEditor();
 	renderAboutWindow();
+	renderStateWindow();
 }
 
 void Main::renderMainMenu()
@@ -185,15 +224,61 @@ void Main::renderMainMenu()
 	//    
 	ImGui::BeginMainMenuBar();
 	if (ImGui::BeginMenu("File")) {
-		ImGui::MenuItem("Load state");
-		ImGui::MenuItem("Save state");
-		ImGui::MenuItem("Save state as");
+		if (ImGui::MenuItem("Load state")) {
+			_isStateWindowOpened = true;
+			_isStateSaving = false;
+			_hasStateError = false;
+		}
+		//     
+		if (ImGui::MenuItem("Save state")) {
+			_hasStateError = !saveState();
+			_isStateWindowOpened = _hasStateError;
+			_isStateSaving = true;
+		}
+		if (ImGui::MenuItem("Save state as")) {
+			_isStateWindowOpened = true;
+			_isStateSaving = true;
+			_hasStateError = false;
+		}
+		ImGui::Separator();
+		ImGui::InputText("Replay", _replayPath, sizeof(_replayPath));
+		if (ImGui::MenuItem("Start recording", nullptr, false, !_replayLog.isOpened()))
+			_hasReplayError = !startRecording();
+		if (ImGui::MenuItem("Stop recording", nullptr, false, _replayLog.isOpened()))
+			_replayLog.close(*_currentWorld);
+		if (_hasReplayError)
+			ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "Failed to start recording");
+		ImGui::Separator();
+		ImGui::InputText("Trace", _tracePath, sizeof(_tracePath));
+		if (ImGui::MenuItem("Start trace", nullptr, false, !Trace::isEnabled())) {
+			Trace::start();
+			_hasTraceError = false;
+		}
+		if (ImGui::MenuItem("Stop trace", nullptr, false, Trace::isEnabled()))
+			_hasTraceError = !Trace::stop(_tracePath);
+		if (_hasTraceError)
+			ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "Failed to write trace");
 		ImGui::EndMenu();
 	}
 	if (ImGui::MenuItem("About")) {
 		_isAboutWindowOpened = true;
 	}
+	if (_stateWriter->isBusy())
+		ImGui::TextDisabled("Saving state...");
+	if (_replayLog.isOpened())
+		ImGui::TextDisabled("Recording");
+	if (Trace::isEnabled())
+		ImGui::TextDisabled("Tracing");
 	ImGui::EndMainMenuBar();
+
+	//         
+	unsigned failedCount = _stateWriter->getFailedCount();
+	if (failedCount != _stateFailedCount) {
+		_stateFailedCount = failedCount;
+		_isStateWindowOpened = true;
+		_isStateSaving = true;
+		_hasStateError = true;
+	}
 }
 
 void Main::renderToolsWindow()
@@ -217,31 +302,47 @@ void Main::renderToolsWindow()
 		_skipStep = true;
 
 	ImGui::SameLine(0.0f, 10.0f);
-	if (ImGui::Button(ICON_MD_REPLAY))
-		_currentWorld->regenerate();
+	//    ,      
+	if (ImGui::Button(ICON_MD_REPLAY)) {
+		_replayLog.regenerate(*_currentWorld, static_cast<uint32_t>(std::chrono::system_clock::now().time_since_epoch().count()));
+		_simulation->markChanged();
+	}
+
+	// -          
+	ImGui::SameLine(0.0f, 10.0f);
+	if (_isTurbo)
+		ImGui::PushStyleColor(ImGuiCol_Button, ImGui::GetStyleColorVec4(ImGuiCol_ButtonActive));
+	bool isTurboPressed = ImGui::Button(ICON_MD_FAST_FORWARD);
+	if (_isTurbo)
+		ImGui::PopStyleColor();
+	if (isTurboPressed)
+		_isTurbo = !_isTurbo;
 	ImGui::PopFont();
 
 	ImGui::SameLine(0.0f, 20.0f);
-	ImGui::DragFloat("Play speed", &_playSpeed, 0.01f, 0.0f, 0.0f, "%.1f");
+	if (_isTurbo)
+		ImGui::DragInt("Steps per frame", &_turboStepsPerFrame, 1.0f, 0, 100000, _turboStepsPerFrame == 0 ? "max" : "%d", ImGuiSliderFlags_AlwaysClamp);
+	else
+		ImGui::DragFloat("Play speed", &_playSpeed, 0.01f, 0.0f, 0.0f, "%.1f");
 
 	ImGui::SameLine(0.0f, 10.0f);
-	ImGui::DragFloat("Zoom", &_currentWorld->cameraZoom, 0.01f, MIN_ZOOM, MAX_ZOOM, "%.2f", ImGuiSliderFlags_AlwaysClamp);
+	ImGui::DragFloat("Zoom", &_worldRenderer->cameraZoom, 0.01f, MIN_ZOOM, MAX_ZOOM, "%.2f", ImGuiSliderFlags_AlwaysClamp);
 	
 	ImGui::SameLine(0.0f, 10.0f);
 	ImGui::SetNextItemWidth(100.0f);
-	ImGui::Combo("Display mode", reinterpret_cast<int*>(&_currentWorld->displayMode), DISPLAY_MODES_STRINGS, DISPLAY_MODES_COUNT);
+	ImGui::Combo("Display mode", reinterpret_cast<int*>(&_worldRenderer->displayMode), DISPLAY_MODES_STRINGS, DISPLAY_MODES_COUNT);
 
 	ImGui::PushFont(_iconicFont);
 	ImGui::SameLine(0.0f, 10.0f);
-	if ((_currentWorld->isGridEnabled && ImGui::Button(ICON_MD_GRID_OFF)) || 
-		(!_currentWorld->isGridEnabled && ImGui::Button(ICON_MD_GRID_ON)))
-		_currentWorld->isGridEnabled = !_currentWorld->isGridEnabled;
+	if ((_worldRenderer->isGridEnabled && ImGui::Button(ICON_MD_GRID_OFF)) || 
+		(!_worldRenderer->isGridEnabled && ImGui::Button(ICON_MD_GRID_ON)))
+		_worldRenderer->isGridEnabled = !_worldRenderer->isGridEnabled;
 
 	ImGui::SameLine(0.0f, 10.0f);
 	if (ImGui::Button(ICON_MD_FULLSCREEN)) {
-		_currentWorld->cameraCenter.x = _currentWorld->getWidth() * 0.5f;
-		_currentWorld->cameraCenter.y = _currentWorld->getHeight() * 0.5f;
-		_currentWorld->cameraZoom = (float)_renderTexture.getSize().x / _currentWorld->getWidth() / TILE_SIZE;
+		_worldRenderer->cameraCenter.x = _currentWorld->getWidth() * 0.5f;
+		_worldRenderer->cameraCenter.y = _currentWorld->getHeight() * 0.5f;
+		_worldRenderer->cameraZoom = (float)_renderTexture.getSize().x / _currentWorld->getWidth() / TILE_SIZE;
 	}
 
 	ImGui::SameLine(0.0f, 10.0f);
@@ -274,6 +375,7 @@ void Main::renderSettingsWindow()
 		ImGui::Text("Steps: %i", _currentWorld->getStepsCount());
 		ImGui::Text("Energy maximum: %.2f", _currentWorld->getEnergyMaximum());
 		ImGui::Text("Alive tiles counter: %i", _currentWorld->getAliveTilesCount());
+		ImGui::Text("Genes counter: %i", _currentWorld->getUsedGenesCount());
 
 		static float fps = 0.0f;
 		static Clock fpsUpdateTimer;
@@ -282,39 +384,69 @@ void Main::renderSettingsWindow()
 			fpsUpdateTimer.restart();
 		}
 
-		ImGui::Text("FPS: %.1f", fps);;
+		//      ,    
+		static float stepsPerSecond = 0.0f;
+		static int lastStepsCount = 0;
+		static Clock stepsUpdateTimer;
+		float stepsTime = stepsUpdateTimer.getElapsedTime().asSeconds();
+		if (stepsTime > 0.5f) {
+			int stepsCount = _currentWorld->getStepsCount();
+			stepsPerSecond = stepsCount >= lastStepsCount ? (stepsCount - lastStepsCount) / stepsTime : 0.0f;
+			lastStepsCount = stepsCount;
+			stepsUpdateTimer.restart();
+		}
+
+		ImGui::Text("FPS: %.1f", fps);
+		ImGui::Text("Steps per second: %.1f", stepsPerSecond);
+
+		//          
+		renderProfiler(_currentWorld->getProfiler(), PROFILER_STEP, PROFILER_STEP_GENES);
+		renderProfiler(_frameProfiler, PROFILER_FRAME, PROFILER_FRAME_DISPLAY);
 	}
 
 	//   
-	Tile* selectedTile = _currentWorld->getSelectedTile();
-	if (selectedTile != nullptr && ImGui::CollapsingHeader("Selected tile stats")) {
-		ImGui::LabelText("Position", "(%i, %i)", _currentWorld->selectedTilePos.x, _currentWorld->selectedTilePos.y);
-		ImGui::LabelText("Eaten food count", "%i", selectedTile->eatenFoodCount);
-		ImGui::LabelText("Photosynth count", "%i", selectedTile->photosynthCount);
-		ImGui::LabelText("Commands counter", "%i", selectedTile->commandsCounter);
+	if (_currentWorld->hasSelectedTile() && ImGui::CollapsingHeader("Selected tile stats")) {
+		auto selectedTilePos = _currentWorld->selectedTilePos;
+		Tile selectedTile = _currentWorld->getTileAt(selectedTilePos.x, selectedTilePos.y);
+		bool isChanged = false;
+
+		ImGui::LabelText("Position", "(%i, %i)", selectedTilePos.x, selectedTilePos.y);
+		ImGui::LabelText("Eaten food count", "%i", selectedTile.eatenFoodCount);
+		ImGui::LabelText("Photosynth count", "%i", selectedTile.photosynthCount);
+		ImGui::LabelText("Commands counter", "%i", selectedTile.commandsCounter);
 
-		ImGui::InputFloat("Energy", &selectedTile->energy, 0.01f, 0.1f);
+		isChanged |= ImGui::InputFloat("Energy", &selectedTile.energy, 0.01f, 0.1f);
 
-		int geneIndex = selectedTile->geneIndex;
+		int geneIndex = selectedTile.geneIndex;
 		if (ImGui::InputInt("Gene index", &geneIndex, 0, 0) && _currentWorld->getGene(geneIndex) != nullptr) {
-			selectedTile->geneIndex = geneIndex;
+			selectedTile.geneIndex = geneIndex;
+			isChanged = true;
 		}
 
-		int direction = selectedTile->direction;
+		int direction = selectedTile.direction;
 		if (ImGui::Combo("Direction", &direction, DIRECTION_NAMES, DIRECTIONS_COUNT)) {
-			selectedTile->direction = static_cast<uint8_t>(direction);
+			selectedTile.direction = static_cast<uint8_t>(direction);
+			isChanged = true;
+		}
+
+		if (isChanged) {
+			_replayLog.setTileAt(*_currentWorld, selectedTilePos.x, selectedTilePos.y, selectedTile);
+			_simulation->markChanged();
 		}
 	}
 
 	//  
 	if (ImGui::CollapsingHeader("World")) {
-		ImGui::InputFloat("Photosynth energy", &_currentWorld->photosynthEnergy, 0.01f, 0.1f);
-		ImGui::InputFloat("Energy spending", &_currentWorld->energySpending, 0.01f, 0.1f);
-		ImGui::InputFloat("Reproduction energy", &_currentWorld->reproductionEnergy, 0.01f, 0.1f);
-		ImGui::InputFloat("Move energy", &_currentWorld->moveEnergy, 0.01f, 0.1f);
-		ImGui::SliderFloat("Mutation chance", &_currentWorld->mutationChance, 0.0f, 1.0f);
-		ImGui::InputFloat("Population density", &_currentWorld->populationDensity, 0.01f, 0.1f);
-		ImGui::InputFloat("Spawn energy", &_currentWorld->spawnEnergy, 0.01f, 0.1f);
+		bool isChanged = false;
+		isChanged |= ImGui::InputFloat("Photosynth energy", &_currentWorld->photosynthEnergy, 0.01f, 0.1f);
+		isChanged |= ImGui::InputFloat("Energy spending", &_currentWorld->energySpending, 0.01f, 0.1f);
+		isChanged |= ImGui::InputFloat("Reproduction energy", &_currentWorld->reproductionEnergy, 0.01f, 0.1f);
+		isChanged |= ImGui::InputFloat("Move energy", &_currentWorld->moveEnergy, 0.01f, 0.1f);
+		isChanged |= ImGui::SliderFloat("Mutation chance", &_currentWorld->mutationChance, 0.0f, 1.0f);
+		isChanged |= ImGui::InputFloat("Population density", &_currentWorld->populationDensity, 0.01f, 0.1f);
+		isChanged |= ImGui::InputFloat("Spawn energy", &_currentWorld->spawnEnergy, 0.01f, 0.1f);
+		if (isChanged)
+			_simulation->markChanged();
 	}
 
 	ImGui::PopItemWidth();
@@ -325,7 +457,7 @@ void Main::renderSettingsWindow()
 			Gene* gene = _currentWorld->getGene(i);
 			if (gene != nullptr) {
 				ImGui::PushID(i);
-				ImGui::TextColored(gene->color, "Gene #%i", i);
+				ImGui::TextColored(toSfColor(gene->color), "Gene #%i", i);
 				ImGui::SameLine(0.0f, 10.0f);
 				if (ImGui::SmallButton("Edit")) {
 					_editingGene = gene;
@@ -339,6 +471,33 @@ void Main::renderSettingsWindow()
 	ImGui::End();
 }
 
+void Main::renderProfiler(Profiler& profiler, ProfilerSection total, ProfilerSection last)
+{
+	if (!ImGui::TreeNode(PROFILER_SECTIONS_STRINGS[total]))
+		return;
+
+	float average = profiler.getAverage(total);
+	ImGui::Text("Average %.2f ms, p50 %.2f, p95 %.2f, max %.2f", average,
+		profiler.getPercentile(total, 50.0f), profiler.getPercentile(total, 95.0f), profiler.getMaximum(total));
+
+	//     
+	char overlay[32];
+	snprintf(overlay, sizeof(overlay), "%.2f ms", average);
+	ImGui::PlotLines("##history", profiler.getHistory(total), profiler.getHistoryCount(), profiler.getHistoryOffset(),
+		overlay, 0.0f, profiler.getMaximum(total), ImVec2(-1.0f, 60.0f));
+
+	//      
+	for (int i = total + 1; i <= last; i++) {
+		ProfilerSection section = static_cast<ProfilerSection>(i);
+		float sectionAverage = profiler.getAverage(section);
+		char label[64];
+		snprintf(label, sizeof(label), "%s: %.2f ms, p95 %.2f", PROFILER_SECTIONS_STRINGS[i], sectionAverage, profiler.getPercentile(section, 95.0f));
+		ImGui::ProgressBar(average > 0.0f ? sectionAverage / average : 0.0f, ImVec2(-1.0f, 0.0f), label);
+	}
+
+	ImGui::TreePop();
+}
+
 void Main::renderSimulationWindow()
 {
 	const ImVec2 simulationPos = ImVec2(WINDOWS_OFFSET_X + SETTINGS_WIDTH + WINDOWS_PADDING_X, WINDOWS_OFFSET_Y + TOOLS_HEIGHT + WINDOWS_PADDING_Y);
@@ -367,28 +526,30 @@ void Main::renderSimulationWindow()
 	ImGui::Image(_renderTexture);
 
 	if (ImGui::IsItemHovered()) {
-		_currentWorld->cameraZoom += _scrollDelta * ZOOM_DRAG;
-		_currentWorld->cameraZoom = Utils::clamp(_currentWorld->cameraZoom, MIN_ZOOM, MAX_ZOOM);
+		_worldRenderer->cameraZoom += _scrollDelta * ZOOM_DRAG;
+		_worldRenderer->cameraZoom = Utils::clamp(_worldRenderer->cameraZoom, MIN_ZOOM, MAX_ZOOM);
 
 		if (ImGui::IsMouseDown(ImGuiMouseButton_Middle)) {
 			//    
-			_currentWorld->cameraCenter -= Vector2f(
-				_mouseDelta.x / _currentWorld->getTileSize(),
-				_mouseDelta.y / _currentWorld->getTileSize()
+			_worldRenderer->cameraCenter -= Vector2f(
+				_mouseDelta.x / _worldRenderer->getTileSize(),
+				_mouseDelta.y / _worldRenderer->getTileSize()
 			);
 
 			//     
-			_currentWorld->cameraCenter.x = Utils::clamp(_currentWorld->cameraCenter.x, 0.0f, static_cast<float>(_currentWorld->getWidth()));
-			_currentWorld->cameraCenter.y = Utils::clamp(_currentWorld->cameraCenter.y, 0.0f, static_cast<float>(_currentWorld->getHeight()));
+			_worldRenderer->cameraCenter.x = Utils::clamp(_worldRenderer->cameraCenter.x, 0.0f, static_cast<float>(_currentWorld->getWidth()));
+			_worldRenderer->cameraCenter.y = Utils::clamp(_worldRenderer->cameraCenter.y, 0.0f, static_cast<float>(_currentWorld->getHeight()));
 
 			ImGui::SetMouseCursor(ImGuiMouseCursor_ResizeAll);
 		}
 
+		//     
 		if (ImGui::IsMouseClicked(ImGuiMouseButton_Left)) {
-			_currentWorld->selectTile(
+			_worldRenderer->selectTile(
 				static_cast<Vector2f>(ImGui::GetMousePos()) - imagePos,
 				Vector2f(_renderTexture.getSize())
 			);
+			_simulation->markChanged();
 		}
 	}
 
@@ -397,6 +558,9 @@ void Main::renderSimulationWindow()
 
 void Main::renderGeneEditor()
 {
+	//    ,      
+	if (_editingGene != nullptr && !_editingGene->isUsed())
+		_editingGene = nullptr;
 	if (_editingGene == nullptr)
 		return;
 
@@ -420,10 +584,14 @@ void Main::renderGeneEditor()
 		_editingGene->color.g / 255.0f,
 		_editingGene->color.b / 255.0f
 	};
-	ImGui::ColorEdit3("Color", color);
-	_editingGene->color.r = static_cast<Uint8>(color[0] * 255.0f);
-	_editingGene->color.g = static_cast<Uint8>(color[1] * 255.0f);
-	_editingGene->color.b = static_cast<Uint8>(color[2] * 255.0f);
+	if (ImGui::ColorEdit3("Color", color)) {
+		::Color geneColor = _editingGene->color;
+		geneColor.r = static_cast<Uint8>(color[0] * 255.0f);
+		geneColor.g = static_cast<Uint8>(color[1] * 255.0f);
+		geneColor.b = static_cast<Uint8>(color[2] * 255.0f);
+		_replayLog.setGeneColor(*_currentWorld, _editingGene->getIndex(), geneColor);
+		_simulation->markChanged();
+	}
 
 	ImGui::NewLine();
 	ImGui::TextUnformatted("Commands: ");
@@ -436,7 +604,8 @@ void Main::renderGeneEditor()
 
 			int command = _editingGene->getCommand(i + k);
 			if (ImGui::InputInt("", &command, 0, 0)) {
-				_editingGene->setCommand(i + k, static_cast<uint8_t>(Utils::clamp(command, 0, 255)));
+				_replayLog.setGeneCommand(*_currentWorld, _editingGene->getIndex(), i + k, static_cast<uint8_t>(Utils::clamp(command, 0, 255)));
+				_simulation->markChanged();
 			}
 
 			ImGui::SameLine(0.0f, 4.0f);
@@ -472,4 +641,80 @@ void Main::renderAboutWindow()
 	ImGui::BulletText("JSON for Modern C++ - https://github.com/nlohmann/json");
 
 	ImGui::End();
+}
+
+void Main::renderStateWindow()
+{
+	if (!_isStateWindowOpened)
+		return;
+
+	ImGui::Begin(_isStateSaving ? "Save state" : "Load state", &_isStateWindowOpened, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoCollapse);
+
+	ImGui::InputText("File", _statePath, sizeof(_statePath));
+
+	if (ImGui::Button(_isStateSaving ? "Save" : "Load")) {
+		_hasStateError = !(_isStateSaving ? saveState() : loadState());
+		if (!_hasStateError)
+			_isStateWindowOpened = false;
+	}
+
+	if (_hasStateError)
+		ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "%s", _isStateSaving ? "Failed to save state" : "Failed to load state");
+
+	ImGui::End();
+}
+
+std::shared_ptr<SnapshotBuffer> Main::captureState()
+{
+	//     ,      
+	if (_stateWriter->isBusy())
+		_stateBuffer = nullptr;
+	_stateBuffer = Snapshot::capture(*_currentWorld, std::move(_stateBuffer));
+	return _stateBuffer;
+}
+
+bool Main::saveState()
+{
+	//   ,       
+	_stateWriter->write(captureState(), _statePath);
+	return true;
+}
+
+bool Main::loadState()
+{
+	//    
+	_stateWriter->flush();
+	auto world = Snapshot::load(_statePath);
+	if (!world)
+		return false;
+
+	//      ,   
+	//       
+	delete _loadedWorld;
+	_loadedWorld = world.release();
+	return true;
+}
+
+void Main::replaceWorld()
+{
+	// , ,  ,         
+	delete _simulation;
+	_replayLog.close(*_currentWorld);
+	_editingGene = nullptr;
+	delete _worldRenderer;
+	delete _currentWorld;
+	_stateBuffer = nullptr;
+	_currentWorld = _loadedWorld;
+	_loadedWorld = nullptr;
+	_currentWorld->setThreadsCount(0);
+	_worldRenderer = new WorldRenderer(*_currentWorld);
+	_simulation = new SimulationThread(*_currentWorld, _replayLog);
+}
+
+bool Main::startRecording()
+{
+	//     ,     
+	std::string prefix = _replayPath;
+	_stateWriter->write(captureState(), prefix + ".sim");
+	return _replayLog.open(*_currentWorld, prefix + ".log");
 }
\ No newline at end of file
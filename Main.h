@@ -1,12 +1,18 @@
 #pragma once
 
-#include <random>
+#include <memory>
 #include <imgui.h>
 #include <SFML/System.hpp>
 #include <SFML/Graphics.hpp>
+#include "Profiler.h"
+#include "ReplayLog.h"
 
 class World;
+class WorldRenderer;
 class Gene;
+class SnapshotWriter;
+struct SnapshotBuffer;
+class SimulationThread;
 
 class Main
 {
@@ -15,15 +21,10 @@ public:
 	static float getTimeDelta();
 	static sf::Vector2f getMouseDelta();
 	static int getScrollDelta();
-	static std::minstd_rand0& getRandomGenerator();
-	static float randomFloat();
 
 	static void start();
 
 private:
-	static std::minstd_rand0 _randomGenerator;
-	static std::uniform_real_distribution<float> _floatDistribution;
-
 	static sf::RenderWindow* _renderWindow;
 	static sf::RenderTexture _renderTexture;
 	static sf::Clock _clock;
@@ -33,15 +34,47 @@ private:
 	static int _scrollDelta;
 
 	static World* _currentWorld;
-	static sf::Clock _stepClock;
+	static WorldRenderer* _worldRenderer;
+	// ,    
+	static SimulationThread* _simulation;
+	//  ,      
+	static World* _loadedWorld;
 	static bool _isPaused;
 	static bool _skipStep;
 	static float _playSpeed;
+	// -       . 0 -    
+	static bool _isTurbo;
+	static int _turboStepsPerFrame;
+	//    
+	static Profiler _frameProfiler;
 
 	static Gene* _editingGene;
 	static ImFont* _iconicFont;
 	static bool _isAboutWindowOpened;
 
+	//     
+	static char _statePath[256];
+	static bool _isStateWindowOpened;
+	//     ,   
+	static bool _isStateSaving;
+	static bool _hasStateError;
+	//    ,     
+	static SnapshotWriter* _stateWriter;
+	//    .         
+	static std::shared_ptr<SnapshotBuffer> _stateBuffer;
+	//    ,    
+	static unsigned _stateFailedCount;
+
+	//  .         
+	static ReplayLog _replayLog;
+	//   :   <>.sim   <>.log
+	static char _replayPath[256];
+	static bool _hasReplayError;
+
+	//   ,       
+	static char _tracePath[256];
+	static bool _hasTraceError;
+
 	static void update();
 	static void handleEvent(sf::Event&);
 	static void release();
@@ -50,7 +83,19 @@ private:
 	static void renderMainMenu();
 	static void renderToolsWindow();
 	static void renderSettingsWindow();
+	//   , ,      total.
+	//     ProfilerSection     last 
+	static void renderProfiler(Profiler& profiler, ProfilerSection total, ProfilerSection last);
 	static void renderSimulationWindow();
 	static void renderGeneEditor();
 	static void renderAboutWindow();
+	static void renderStateWindow();
+
+	//       
+	static std::shared_ptr<SnapshotBuffer> captureState();
+	static bool saveState();
+	static bool loadState();
+	static bool startRecording();
+	//    . ,    
+	static void replaceWorld();
 };
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <math.h>
+#include "Profiler.h"
+#include "Trace.h"
+
+const char* PROFILER_SECTIONS_STRINGS[] = {
+	"Step", "Prepare", "Tiles", "Genes",
+	"Frame", "Events", "World render", "World lock", "Interface", "Display"
+};
+
+Profiler::Profiler()
+{
+	std::fill(_current, _current + PROFILER_SECTIONS_COUNT, 0.0f);
+	std::fill(&_history[0][0], &_history[0][0] + PROFILER_SECTIONS_COUNT * PROFILER_HISTORY_SIZE, 0.0f);
+}
+
+void Profiler::add(ProfilerSection section, double seconds)
+{
+	_current[section] += static_cast<float>(seconds * 1000.0);
+}
+
+void Profiler::commit()
+{
+	for (int i = 0; i < PROFILER_SECTIONS_COUNT; i++) {
+		_history[i][_historyIndex] = _current[i];
+		_current[i] = 0.0f;
+	}
+	_historyIndex = (_historyIndex + 1) % PROFILER_HISTORY_SIZE;
+	_historyCount = std::min(_historyCount + 1, PROFILER_HISTORY_SIZE);
+}
+
+float Profiler::getAverage(ProfilerSection section)
+{
+	if (_historyCount == 0)
+		return 0.0f;
+	//    ,     
+	float sum = 0.0f;
+	for (int i = 0; i < _historyCount; i++)
+		sum += _history[section][i];
+	return sum / _historyCount;
+}
+
+float Profiler::getPercentile(ProfilerSection section, float percent)
+{
+	if (_historyCount == 0)
+		return 0.0f;
+	float values[PROFILER_HISTORY_SIZE];
+	std::copy(_history[section], _history[section] + _historyCount, values);
+	int rank = std::min(_historyCount - 1, static_cast<int>(ceilf(percent / 100.0f * _historyCount)) - 1);
+	rank = std::max(0, rank);
+	std::nth_element(values, values + rank, values + _historyCount);
+	return values[rank];
+}
+
+float Profiler::getMaximum(ProfilerSection section)
+{
+	if (_historyCount == 0)
+		return 0.0f;
+	return *std::max_element(_history[section], _history[section] + _historyCount);
+}
+
+const float* Profiler::getHistory(ProfilerSection section)
+{
+	return _history[section];
+}
+
+int Profiler::getHistoryOffset()
+{
+	return _historyCount < PROFILER_HISTORY_SIZE ? 0 : _historyIndex;
+}
+
+int Profiler::getHistoryCount()
+{
+	return _historyCount;
+}
+
+ProfilerScope::ProfilerScope(Profiler& profiler, ProfilerSection section)
+{
+	_profiler = &profiler;
+	_section = section;
+	_start = Trace::now();
+}
+
+ProfilerScope::~ProfilerScope()
+{
+	stop();
+}
+
+void ProfilerScope::stop()
+{
+	if (_profiler == nullptr)
+		return;
+	int64_t end = Trace::now();
+	_profiler->add(_section, (end - _start) / 1e9);
+	if (Trace::isEnabled())
+		Trace::addEvent(PROFILER_SECTIONS_STRINGS[_section], _start, end);
+	_profiler = nullptr;
+}
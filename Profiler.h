@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stdint.h>
+
+//      ,    
+enum ProfilerSection {
+	//      
+	PROFILER_STEP, PROFILER_STEP_PREPARE, PROFILER_STEP_TILES, PROFILER_STEP_GENES,
+	//   ,    ,   
+	PROFILER_FRAME, PROFILER_FRAME_EVENTS, PROFILER_FRAME_WORLD, PROFILER_FRAME_LOCK, PROFILER_FRAME_GUI, PROFILER_FRAME_DISPLAY,
+	PROFILER_SECTIONS_COUNT
+};
+
+//    
+extern const char* PROFILER_SECTIONS_STRINGS[];
+
+//   ,    
+#define PROFILER_HISTORY_SIZE	120
+
+//     .      ,
+//  commit    .  :      
+class Profiler
+{
+public:
+	Profiler();
+
+	//      
+	void add(ProfilerSection section, double seconds);
+	//          
+	void commit();
+
+	//     
+	float getAverage(ProfilerSection section);
+	//    ,      
+	float getPercentile(ProfilerSection section, float percent);
+	float getMaximum(ProfilerSection section);
+
+	//      .       getHistoryOffset
+	const float* getHistory(ProfilerSection section);
+	int getHistoryOffset();
+	int getHistoryCount();
+
+private:
+	float _current[PROFILER_SECTIONS_COUNT];
+	float _history[PROFILER_SECTIONS_COUNT][PROFILER_HISTORY_SIZE];
+	int _historyIndex = 0;
+	int _historyCount = 0;
+};
+
+//          stop.
+//      (. Trace)     
+class ProfilerScope
+{
+public:
+	ProfilerScope(Profiler& profiler, ProfilerSection section);
+	~ProfilerScope();
+
+	//    
+	void stop();
+
+private:
+	Profiler* _profiler;
+	ProfilerSection _section;
+	int64_t _start;
+};
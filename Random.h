@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stdint.h>
+
+//       (Philox4x32-10).
+//      ,  ,    ,
+//             
+class Random
+{
+public:
+	//     ,      
+	enum Stream : uint32_t {
+		STREAM_STEP, STREAM_REGENERATE, STREAM_GENES
+	};
+
+	Random(uint32_t seed, uint32_t step, uint32_t index, Stream stream) {
+		_key[0] = seed;
+		_key[1] = 0x5EED5EEDu;
+		_counter[0] = index;
+		_counter[1] = step;
+		_counter[2] = stream;
+		_counter[3] = 0;
+	}
+
+	//  32- 
+	uint32_t next() {
+		if (_outputIndex >= 4) {
+			generate();
+			_outputIndex = 0;
+		}
+		return _output[_outputIndex++];
+	}
+
+	//    0  1,   1
+	float nextFloat() {
+		return (next() >> 8) * (1.0f / 16777216.0f);
+	}
+
+	//    0  count - 1
+	int nextInt(int count) {
+		return static_cast<int>((static_cast<uint64_t>(next()) * static_cast<uint32_t>(count)) >> 32);
+	}
+
+private:
+	uint32_t _key[2];
+	uint32_t _counter[4];
+	uint32_t _output[4];
+	uint8_t _outputIndex = 4;
+
+	static void multiply(uint32_t a, uint32_t b, uint32_t& high, uint32_t& low) {
+		uint64_t product = static_cast<uint64_t>(a) * b;
+		high = static_cast<uint32_t>(product >> 32);
+		low = static_cast<uint32_t>(product);
+	}
+
+	void generate() {
+		uint32_t c0 = _counter[0], c1 = _counter[1], c2 = _counter[2], c3 = _counter[3];
+		uint32_t k0 = _key[0], k1 = _key[1];
+
+		for (int round = 0; round < 10; round++) {
+			uint32_t high0, low0, high1, low1;
+			multiply(0xD2511F53u, c0, high0, low0);
+			multiply(0xCD9E8D57u, c2, high1, low1);
+
+			c0 = high1 ^ c1 ^ k0;
+			c1 = low1;
+			c2 = high0 ^ c3 ^ k1;
+			c3 = low0;
+
+			k0 += 0x9E3779B9u;
+			k1 += 0xBB67AE85u;
+		}
+
+		_output[0] = c0;
+		_output[1] = c1;
+		_output[2] = c2;
+		_output[3] = c3;
+
+		//      
+		_counter[3]++;
+	}
+};
@@ -0,0 +1,309 @@
+#include <string.h>
+#include "Tile.h"
+#include "World.h"
+#include "ReplayLog.h"
+
+#define REPLAY_MAGIC	"SIMR"
+#define REPLAY_VERSION	1
+
+//   
+#define EVENT_PARAMETER		0
+#define EVENT_REGENERATE	1
+#define EVENT_TILE			2
+#define EVENT_GENE_COMMAND	3
+#define EVENT_GENE_COLOR	4
+#define EVENT_STOP			5
+#define EVENTS_COUNT		6
+
+//        
+static float World::* const PARAMETERS[] = {
+	&World::photosynthEnergy,
+	&World::energySpending,
+	&World::reproductionEnergy,
+	&World::moveEnergy,
+	&World::mutationChance,
+	&World::populationDensity,
+	&World::spawnEnergy,
+};
+static_assert(sizeof(PARAMETERS) / sizeof(PARAMETERS[0]) == REPLAY_PARAMETERS_COUNT, "Parameters table does not match REPLAY_PARAMETERS_COUNT");
+
+//  .          
+struct ReplayHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t width;
+	uint32_t height;
+	uint32_t startStep;
+	uint32_t reserved;
+	uint64_t startChecksum;
+};
+
+//   -   (4 ),   (1 )      .
+//           
+#pragma pack(push, 1)
+struct ReplayParameter
+{
+	uint8_t parameter;
+	float value;
+};
+
+struct ReplayTile
+{
+	uint16_t x;
+	uint16_t y;
+	float temp;
+	float energy;
+	uint32_t eatenFoodCount;
+	uint32_t photosynthCount;
+	uint16_t geneIndex;
+	uint8_t direction;
+	uint8_t commandsCounter;
+};
+
+struct ReplayGeneCommand
+{
+	uint16_t geneIndex;
+	uint8_t num;
+	uint8_t command;
+};
+
+struct ReplayGeneColor
+{
+	uint16_t geneIndex;
+	Color color;
+};
+#pragma pack(pop)
+
+//     
+static const size_t EVENT_SIZES[EVENTS_COUNT] = {
+	sizeof(ReplayParameter),
+	sizeof(uint32_t),
+	sizeof(ReplayTile),
+	sizeof(ReplayGeneCommand),
+	sizeof(ReplayGeneColor),
+	sizeof(uint64_t),
+};
+
+ReplayLog::ReplayLog()
+{
+	memset(_parameters, 0, sizeof(_parameters));
+}
+
+ReplayLog::~ReplayLog()
+{
+	//      .       
+	_file.close();
+}
+
+bool ReplayLog::open(World& world, const std::string& path)
+{
+	_file.close();
+	_file.clear();
+	_file.open(path, std::ios::binary | std::ios::trunc);
+	if (!_file)
+		return false;
+
+	ReplayHeader header = {};
+	memcpy(header.magic, REPLAY_MAGIC, sizeof(header.magic));
+	header.version = REPLAY_VERSION;
+	header.width = world.getWidth();
+	header.height = world.getHeight();
+	header.startStep = world.getStepsCount();
+	header.startChecksum = world.getChecksum();
+	_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	//    ,         
+	writeParameters(world, true);
+	if (!_file) {
+		_file.close();
+		return false;
+	}
+	return true;
+}
+
+void ReplayLog::close(World& world)
+{
+	if (!_file.is_open())
+		return;
+
+	uint64_t checksum = world.getChecksum();
+	writeEvent(world, EVENT_STOP, &checksum, sizeof(checksum));
+	_file.close();
+}
+
+bool ReplayLog::isOpened()
+{
+	return _file.is_open();
+}
+
+void ReplayLog::update(World& world)
+{
+	writeParameters(world, false);
+	world.update();
+}
+
+void ReplayLog::regenerate(World& world, uint32_t seed)
+{
+	//         
+	writeParameters(world, false);
+	writeEvent(world, EVENT_REGENERATE, &seed, sizeof(seed));
+	world.seed(seed);
+	world.regenerate();
+}
+
+void ReplayLog::setTileAt(World& world, int x, int y, const Tile& tile)
+{
+	world.setTileAt(x, y, tile);
+
+	//       
+	ReplayTile record;
+	record.x = static_cast<uint16_t>((x % world.getWidth() + world.getWidth()) % world.getWidth());
+	record.y = static_cast<uint16_t>((y % world.getHeight() + world.getHeight()) % world.getHeight());
+	record.temp = tile.temp;
+	record.energy = tile.energy;
+	record.eatenFoodCount = tile.eatenFoodCount;
+	record.photosynthCount = tile.photosynthCount;
+	record.geneIndex = tile.geneIndex;
+	record.direction = tile.direction;
+	record.commandsCounter = tile.commandsCounter;
+	writeEvent(world, EVENT_TILE, &record, sizeof(record));
+}
+
+void ReplayLog::setGeneCommand(World& world, uint16_t geneIndex, uint8_t num, uint8_t command)
+{
+	//     ,       
+	if (world.getGene(geneIndex) == nullptr)
+		return;
+	world.setGeneCommand(geneIndex, num, command);
+
+	ReplayGeneCommand record = { geneIndex, num, command };
+	writeEvent(world, EVENT_GENE_COMMAND, &record, sizeof(record));
+}
+
+void ReplayLog::setGeneColor(World& world, uint16_t geneIndex, Color color)
+{
+	if (world.getGene(geneIndex) == nullptr)
+		return;
+	world.setGeneColor(geneIndex, color);
+
+	ReplayGeneColor record = { geneIndex, color };
+	writeEvent(world, EVENT_GENE_COLOR, &record, sizeof(record));
+}
+
+bool ReplayLog::play(World& world, const std::string& path, uint32_t untilStep)
+{
+	std::ifstream file(path, std::ios::binary);
+	ReplayHeader header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+		return false;
+	if (memcmp(header.magic, REPLAY_MAGIC, sizeof(header.magic)) != 0 || header.version != REPLAY_VERSION)
+		return false;
+	if (header.width != static_cast<uint32_t>(world.getWidth()) || header.height != static_cast<uint32_t>(world.getHeight()))
+		return false;
+	if (header.startStep != static_cast<uint32_t>(world.getStepsCount()) || header.startChecksum != world.getChecksum())
+		return false;
+
+	uint8_t data[sizeof(ReplayTile)];
+	while (true) {
+		uint32_t step;
+		uint8_t type;
+		if (!file.read(reinterpret_cast<char*>(&step), sizeof(step)))
+			break;
+		if (!file.read(reinterpret_cast<char*>(&type), sizeof(type)) || type >= EVENTS_COUNT)
+			return false;
+		if (!file.read(reinterpret_cast<char*>(data), EVENT_SIZES[type]))
+			return false;
+
+		//      
+		while (static_cast<uint32_t>(world.getStepsCount()) < step && static_cast<uint32_t>(world.getStepsCount()) < untilStep)
+			world.update();
+		if (static_cast<uint32_t>(world.getStepsCount()) >= untilStep)
+			return true;
+
+		switch (type) {
+		case EVENT_PARAMETER: {
+			ReplayParameter record;
+			memcpy(&record, data, sizeof(record));
+			if (record.parameter >= REPLAY_PARAMETERS_COUNT)
+				return false;
+			world.*PARAMETERS[record.parameter] = record.value;
+			break;
+		}
+		case EVENT_REGENERATE: {
+			uint32_t seed;
+			memcpy(&seed, data, sizeof(seed));
+			world.seed(seed);
+			world.regenerate();
+			break;
+		}
+		case EVENT_TILE: {
+			ReplayTile record;
+			memcpy(&record, data, sizeof(record));
+			if (record.geneIndex != 0 && world.getGene(record.geneIndex) == nullptr)
+				return false;
+			Tile tile;
+			tile.temp = record.temp;
+			tile.energy = record.energy;
+			tile.eatenFoodCount = record.eatenFoodCount;
+			tile.photosynthCount = record.photosynthCount;
+			tile.geneIndex = record.geneIndex;
+			tile.direction = record.direction;
+			tile.commandsCounter = record.commandsCounter;
+			world.setTileAt(record.x, record.y, tile);
+			break;
+		}
+		case EVENT_GENE_COMMAND: {
+			ReplayGeneCommand record;
+			memcpy(&record, data, sizeof(record));
+			//   ,    
+			world.setGeneCommand(record.geneIndex, record.num, record.command);
+			break;
+		}
+		case EVENT_GENE_COLOR: {
+			ReplayGeneColor record;
+			memcpy(&record, data, sizeof(record));
+			world.setGeneColor(record.geneIndex, record.color);
+			break;
+		}
+		case EVENT_STOP: {
+			uint64_t checksum;
+			memcpy(&checksum, data, sizeof(checksum));
+			return checksum == world.getChecksum();
+		}
+		}
+	}
+
+	//    ,     
+	return true;
+}
+
+void ReplayLog::writeParameters(World& world, bool force)
+{
+	for (uint8_t i = 0; i < REPLAY_PARAMETERS_COUNT; i++) {
+		float value = world.*PARAMETERS[i];
+		//  ,      
+		if (!force && memcmp(&value, &_parameters[i], sizeof(value)) == 0)
+			continue;
+		_parameters[i] = value;
+
+		ReplayParameter record = { i, value };
+		writeEvent(world, EVENT_PARAMETER, &record, sizeof(record));
+	}
+}
+
+void ReplayLog::writeEvent(World& world, uint8_t type, const void* data, size_t size)
+{
+	if (!_file.is_open())
+		return;
+
+	uint8_t buffer[sizeof(uint32_t) + 1 + sizeof(ReplayTile)];
+	uint32_t step = world.getStepsCount();
+	memcpy(buffer, &step, sizeof(step));
+	buffer[sizeof(step)] = type;
+	memcpy(buffer + sizeof(step) + 1, data, size);
+
+	//  ,     ,     
+	_file.write(reinterpret_cast<const char*>(buffer), static_cast<std::streamsize>(sizeof(step) + 1 + size));
+	_file.flush();
+}
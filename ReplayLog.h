@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stdint.h>
+#include <fstream>
+#include <string>
+#include "Color.h"
+
+//   ,     
+#define REPLAY_PARAMETERS_COUNT	7
+
+class World;
+class Tile;
+
+//     :  ,     ,
+//    ,    .    ,  
+//   ,      ,    .
+//   ,   ,    .
+//    ,    
+class ReplayLog
+{
+public:
+	ReplayLog();
+	~ReplayLog();
+
+	ReplayLog(const ReplayLog&) = delete;
+	ReplayLog& operator=(const ReplayLog&) = delete;
+
+	//      .  false,     
+	bool open(World& world, const std::string& path);
+	//  .          
+	void close(World& world);
+	bool isOpened();
+
+	//   .        
+	void update(World& world);
+	//     .    ,      
+	void regenerate(World& world, uint32_t seed);
+	void setTileAt(World& world, int x, int y, const Tile& tile);
+	void setGeneCommand(World& world, uint16_t geneIndex, uint8_t num, uint8_t command);
+	void setGeneColor(World& world, uint16_t geneIndex, Color color);
+
+	//    ,     ,     .
+	//     untilStep    .
+	//  false,      ,      
+	static bool play(World& world, const std::string& path, uint32_t untilStep = UINT32_MAX);
+
+private:
+	std::ofstream _file;
+	//   ,    
+	float _parameters[REPLAY_PARAMETERS_COUNT];
+
+	//  ,    .  force,   
+	void writeParameters(World& world, bool force);
+	void writeEvent(World& world, uint8_t type, const void* data, size_t size);
+};
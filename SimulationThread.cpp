@@ -0,0 +1,136 @@
+#include "ReplayLog.h"
+#include "Trace.h"
+#include "World.h"
+#include "SimulationThread.h"
+
+SimulationThread::SimulationThread(World& world, ReplayLog& replayLog) : _world(world), _replayLog(replayLog)
+{
+	_waitingCount = 0;
+	_readyFrame = 2;
+	_thread = std::thread(&SimulationThread::threadLoop, this);
+}
+
+SimulationThread::~SimulationThread()
+{
+	//  -       
+	lockWorld();
+	_isStopping = true;
+	unlockWorld();
+	_thread.join();
+}
+
+void SimulationThread::lockWorld()
+{
+	_waitingCount++;
+	_mutex.lock();
+	_waitingCount--;
+}
+
+void SimulationThread::unlockWorld()
+{
+	_mutex.unlock();
+	_condition.notify_all();
+}
+
+void SimulationThread::setPaused(bool isPaused)
+{
+	_isPaused = isPaused;
+}
+
+void SimulationThread::setStepsPerSecond(float stepsPerSecond)
+{
+	_stepsPerSecond = stepsPerSecond;
+}
+
+void SimulationThread::setTurbo(bool isTurbo, uint32_t stepsPerFrame)
+{
+	_isTurbo = isTurbo;
+	_turboStepsPerFrame = stepsPerFrame;
+}
+
+void SimulationThread::requestStep()
+{
+	_stepRequests++;
+}
+
+void SimulationThread::markChanged()
+{
+	_isChanged = true;
+}
+
+WorldFrame& SimulationThread::acquireFrame()
+{
+	//   ,   
+	if (_readyFrame.load(std::memory_order_relaxed) & FRAME_FRESH)
+		_readFrame = _readyFrame.exchange(_readFrame, std::memory_order_acq_rel) & ~FRAME_FRESH;
+	return _frames[_readFrame];
+}
+
+void SimulationThread::threadLoop()
+{
+	Trace::setThreadName("Simulation");
+	using Clock = std::chrono::steady_clock;
+	Clock::time_point nextStepTime = Clock::now();
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true) {
+		//  ,  ,       .
+		//    :         
+		if (_waitingCount.load() > 0) {
+			_condition.wait(lock, [this] { return _waitingCount.load() == 0; });
+			continue;
+		}
+		if (_isStopping)
+			return;
+
+		Clock::time_point now = Clock::now();
+		bool isStepTime = false;
+		if (!_isPaused) {
+			if (_isTurbo)
+				isStepTime = _turboStepsPerFrame == 0 || _frameSteps < _turboStepsPerFrame;
+			else
+				isStepTime = _stepsPerSecond > 0.0f && now >= nextStepTime;
+		}
+
+		//     ,     .
+		//  -     -    
+		bool isFrameTaken = !(_readyFrame.load(std::memory_order_acquire) & FRAME_FRESH);
+		bool isBatchRunning = _isTurbo && _turboStepsPerFrame > 0 && isStepTime && _frameSteps > 0;
+		if (isFrameTaken && (_isChanged || _frameSteps > 0) && !isBatchRunning) {
+			_isChanged = false;
+			_frameSteps = 0;
+			publishFrame();
+			continue;
+		}
+
+		if (_stepRequests == 0 && !isStepTime) {
+			// - ,    ,    
+			if (_isPaused || _isTurbo || _stepsPerSecond <= 0.0f)
+				_condition.wait(lock);
+			else
+				_condition.wait_until(lock, nextStepTime);
+			continue;
+		}
+
+		_replayLog.update(_world);
+		_frameSteps++;
+		if (_stepRequests > 0)
+			_stepRequests--;
+
+		if (_isTurbo)
+			nextStepTime = now;
+		else if (isStepTime) {
+			//        
+			auto interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / _stepsPerSecond));
+			nextStepTime += interval;
+			if (nextStepTime < now)
+				nextStepTime = now + interval;
+		}
+	}
+}
+
+void SimulationThread::publishFrame()
+{
+	_frames[_writeFrame].capture(_world);
+	_writeFrame = _readyFrame.exchange(_writeFrame | FRAME_FRESH, std::memory_order_acq_rel) & ~FRAME_FRESH;
+}
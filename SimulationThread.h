@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "WorldFrame.h"
+
+class World;
+class ReplayLog;
+
+// ,      .    
+//    ,      .
+//          :  
+//        ,     .
+//         lockWorld  unlockWorld
+class SimulationThread
+{
+public:
+	//    ,     
+	SimulationThread(World& world, ReplayLog& replayLog);
+	~SimulationThread();
+
+	SimulationThread(const SimulationThread&) = delete;
+	SimulationThread& operator=(const SimulationThread&) = delete;
+
+	//        .     
+	//     unlockWorld
+	void lockWorld();
+	void unlockWorld();
+
+	//   .   lockWorld  unlockWorld
+	void setPaused(bool isPaused);
+	void setStepsPerSecond(float stepsPerSecond);
+	// -:    ,     stepsPerFrame .
+	//  stepsPerFrame,  0,     ,   
+	void setTurbo(bool isTurbo, uint32_t stepsPerFrame);
+	//   ,     
+	void requestStep();
+	// ,    ,      .
+	//   lockWorld  unlockWorld
+	void markChanged();
+
+	//    .      
+	WorldFrame& acquireFrame();
+
+private:
+	//  ,    _readyFrame    
+	static const uint8_t FRAME_FRESH = 4;
+
+	World& _world;
+	ReplayLog& _replayLog;
+	std::thread _thread;
+	std::mutex _mutex;
+	std::condition_variable _condition;
+	//  ,   .      
+	std::atomic<unsigned> _waitingCount;
+
+	bool _isPaused = true;
+	float _stepsPerSecond = 1.0f;
+	unsigned _stepRequests = 0;
+	bool _isTurbo = false;
+	uint32_t _turboStepsPerFrame = 0;
+	//      
+	uint32_t _frameSteps = 0;
+	//    ,       
+	bool _isChanged = true;
+	bool _isStopping = false;
+
+	WorldFrame _frames[3];
+	// ,    ,  ,   
+	uint8_t _writeFrame = 0;
+	uint8_t _readFrame = 1;
+	//     FRAME_FRESH
+	std::atomic<uint8_t> _readyFrame;
+
+	void threadLoop();
+	//         
+	void publishFrame();
+};
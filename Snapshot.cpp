@@ -0,0 +1,761 @@
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <fstream>
+#include <vector>
+#include "Config.h"
+#include "Gene.h"
+#include "MappedFile.h"
+#include "TileStorage.h"
+#include "Trace.h"
+#include "World.h"
+#include "Snapshot.h"
+
+#define SNAPSHOT_MAGIC		"SIMW"
+#define SNAPSHOT_VERSION	2
+//     ,        
+#define SNAPSHOT_SECTION_ALIGNMENT	4096
+
+//  :   ,       
+#define SNAPSHOT_SECTION_GENES				TileStorage::PERSISTENT_ARRAYS_COUNT
+#define SNAPSHOT_SECTION_FREE_GENE_SLOTS	(TileStorage::PERSISTENT_ARRAYS_COUNT + 1)
+#define SNAPSHOT_SECTIONS_COUNT				(TileStorage::PERSISTENT_ARRAYS_COUNT + 2)
+
+#define DELTA_MAGIC			"SIMD"
+#define DELTA_VERSION		1
+//   ,    
+#define DELTA_CHUNK_SIZE	64
+
+//  
+struct SnapshotParameters
+{
+	float photosynthEnergy;
+	float energySpending;
+	float reproductionEnergy;
+	float moveEnergy;
+	float mutationChance;
+	float populationDensity;
+	float spawnEnergy;
+};
+
+//  .    ,   -   
+struct SnapshotHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t width;
+	uint32_t height;
+	uint32_t seed;
+	uint32_t stepCounter;
+	uint32_t aliveTilesCounter;
+	float maxEnergy;
+	SnapshotParameters parameters;
+	//        
+	uint32_t genesCount;
+	uint32_t freeGeneSlotsCount;
+	//          
+	uint64_t sectionOffsets[SNAPSHOT_SECTIONS_COUNT];
+	uint64_t sectionSizes[SNAPSHOT_SECTIONS_COUNT];
+};
+
+//     .     
+struct SnapshotGene
+{
+	uint16_t index;
+	uint16_t parentIndex;
+	uint16_t mutationsCount;
+	uint16_t reserved;
+	Color color;
+	uint8_t commands[GENE_COMMANDS_COUNT];
+};
+
+//   .       ,
+//    ,       .
+//   -   ,       
+struct DeltaHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t width;
+	uint32_t height;
+	uint32_t seed;
+	// ,    ,    ,    
+	uint32_t fromStep;
+	uint32_t toStep;
+	uint32_t aliveTilesCounter;
+	float maxEnergy;
+	SnapshotParameters parameters;
+	uint32_t genesCount;
+	uint32_t freeGeneSlotsCount;
+	uint32_t changedGenesCount;
+	uint32_t rangesCount;
+};
+
+// ,   .       ,
+//   -  .   -       
+struct SnapshotBuffer
+{
+	bool isDelta;
+	SnapshotHeader header;
+	DeltaHeader deltaHeader;
+	std::vector<uint8_t> arrays[TileStorage::PERSISTENT_ARRAYS_COUNT];
+	//  ,         arrays
+	TileStorage* tiles = nullptr;
+	//   ,    arrays  . 0 -   
+	uint32_t capturedEpoch = 0;
+	std::vector<SnapshotGene> genes;
+	std::vector<uint16_t> changedSlots;
+	std::vector<uint16_t> freeGeneSlots;
+	//         
+	std::vector<uint32_t> ranges;
+};
+
+static uint64_t alignSection(uint64_t offset)
+{
+	return (offset + SNAPSHOT_SECTION_ALIGNMENT - 1) & ~static_cast<uint64_t>(SNAPSHOT_SECTION_ALIGNMENT - 1);
+}
+
+//     
+static void writePadding(std::ofstream& file, uint64_t& position, uint64_t offset)
+{
+	static const char zeros[SNAPSHOT_SECTION_ALIGNMENT] = {};
+	while (position < offset) {
+		uint64_t size = offset - position < sizeof(zeros) ? offset - position : sizeof(zeros);
+		file.write(zeros, static_cast<std::streamsize>(size));
+		position += size;
+	}
+}
+
+//    .    ,       ,
+//         
+#ifdef _WIN32
+static bool replaceFile(const std::string& tempPath, const std::string& path)
+{
+	if (MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+		return true;
+
+	// ,     ,    ,   :
+	// MappedFile    FILE_SHARE_DELETE.   ,     
+	//   ,     .       
+	std::string oldPath = path + ".old";
+	if (!MoveFileExA(path.c_str(), oldPath.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+		DeleteFileA(tempPath.c_str());
+		return false;
+	}
+	if (!MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_WRITE_THROUGH)) {
+		MoveFileExA(oldPath.c_str(), path.c_str(), 0);
+		DeleteFileA(tempPath.c_str());
+		return false;
+	}
+	DeleteFileA(oldPath.c_str());
+	return true;
+}
+#else
+static bool replaceFile(const std::string& tempPath, const std::string& path)
+{
+	// rename   .     
+	if (rename(tempPath.c_str(), path.c_str()) != 0) {
+		remove(tempPath.c_str());
+		return false;
+	}
+	return true;
+}
+#endif
+
+static void append(std::vector<uint8_t>& output, const void* data, size_t size)
+{
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	output.insert(output.end(), bytes, bytes + size);
+}
+
+//      
+struct DeltaReader
+{
+	const uint8_t* data;
+	size_t size;
+	size_t position;
+
+	bool read(void* output, size_t count) {
+		if (count > size - position)
+			return false;
+		if (count > 0)
+			memcpy(output, data + position, count);
+		position += count;
+		return true;
+	}
+};
+
+//   .      
+// (  ,     ..),     (PackBits).
+//        ,    
+static void packArray(const uint8_t* data, size_t count, size_t elementSize, std::vector<uint8_t>& planes, std::vector<uint8_t>& output)
+{
+	size_t size = count * elementSize;
+	planes.resize(size);
+	for (size_t i = 0; i < count; i++) {
+		for (size_t k = 0; k < elementSize; k++)
+			planes[k * count + i] = data[i * elementSize + k];
+	}
+
+	size_t i = 0;
+	while (i < size) {
+		size_t run = 1;
+		while (i + run < size && run < 128 && planes[i + run] == planes[i])
+			run++;
+
+		if (run >= 3) {
+			output.push_back(static_cast<uint8_t>(257 - run));
+			output.push_back(planes[i]);
+			i += run;
+			continue;
+		}
+
+		//        
+		size_t end = i;
+		while (end < size && end - i < 128) {
+			if (end + 2 < size && planes[end] == planes[end + 1] && planes[end] == planes[end + 2])
+				break;
+			end++;
+		}
+		output.push_back(static_cast<uint8_t>(end - i - 1));
+		output.insert(output.end(), planes.begin() + i, planes.begin() + end);
+		i = end;
+	}
+}
+
+//  ,  packArray.  false,   
+static bool unpackArray(const uint8_t* input, size_t inputSize, size_t count, size_t elementSize, std::vector<uint8_t>& planes, uint8_t* output)
+{
+	size_t size = count * elementSize;
+	planes.resize(size);
+
+	size_t position = 0;
+	size_t i = 0;
+	while (i < inputSize) {
+		uint8_t header = input[i++];
+		if (header < 128) {
+			size_t length = header + 1u;
+			if (length > inputSize - i || length > size - position)
+				return false;
+			memcpy(planes.data() + position, input + i, length);
+			i += length;
+			position += length;
+		} else {
+			size_t length = 257u - header;
+			if (i >= inputSize || length > size - position)
+				return false;
+			memset(planes.data() + position, input[i++], length);
+			position += length;
+		}
+	}
+	if (position != size)
+		return false;
+
+	for (size_t n = 0; n < count; n++) {
+		for (size_t k = 0; k < elementSize; k++)
+			output[n * elementSize + k] = planes[k * count + n];
+	}
+	return true;
+}
+
+void Snapshot::writeParameters(World& world, SnapshotParameters& parameters)
+{
+	parameters.photosynthEnergy = world.photosynthEnergy;
+	parameters.energySpending = world.energySpending;
+	parameters.reproductionEnergy = world.reproductionEnergy;
+	parameters.moveEnergy = world.moveEnergy;
+	parameters.mutationChance = world.mutationChance;
+	parameters.populationDensity = world.populationDensity;
+	parameters.spawnEnergy = world.spawnEnergy;
+}
+
+void Snapshot::readParameters(World& world, const SnapshotParameters& parameters)
+{
+	world.photosynthEnergy = parameters.photosynthEnergy;
+	world.energySpending = parameters.energySpending;
+	world.reproductionEnergy = parameters.reproductionEnergy;
+	world.moveEnergy = parameters.moveEnergy;
+	world.mutationChance = parameters.mutationChance;
+	world.populationDensity = parameters.populationDensity;
+	world.spawnEnergy = parameters.spawnEnergy;
+}
+
+void Snapshot::writeGene(Gene& gene, SnapshotGene& record)
+{
+	record = {};
+	if (!gene.isUsed())
+		return;
+	record.index = gene._index;
+	record.parentIndex = gene._parentIndex;
+	record.mutationsCount = gene._mutationsCount;
+	record.color = gene.color;
+	memcpy(record.commands, gene._commands, GENE_COMMANDS_COUNT);
+}
+
+void Snapshot::readGene(Gene& gene, const SnapshotGene& record)
+{
+	if (record.index == 0) {
+		gene.release();
+		return;
+	}
+	gene.init(record.index, record.parentIndex);
+	gene._mutationsCount = record.mutationsCount;
+	gene.color = record.color;
+	memcpy(gene._commands, record.commands, GENE_COMMANDS_COUNT);
+}
+
+bool Snapshot::rebuildTileState(World& world)
+{
+	const uint16_t* geneIndices = world._tiles->geneIndex;
+	size_t count = world._tiles->getCount();
+
+	world._usedGenesCount = 0;
+	for (uint16_t i = 0; i < world._genesCount; i++) {
+		if (world._genes[i].isUsed())
+			world._usedGenesCount++;
+	}
+
+	std::vector<uint32_t> references(static_cast<size_t>(world._genesCount) + 1);
+	for (size_t word = 0; word < world._aliveMaskSize; word++) {
+		uint64_t bits = 0;
+		size_t end = (word + 1) * 64 < count ? (word + 1) * 64 : count;
+		for (size_t i = word * 64; i < end; i++) {
+			uint16_t geneIndex = geneIndices[i];
+			if (geneIndex == 0)
+				continue;
+			if (world.getGene(geneIndex) == nullptr)
+				return false;
+			references[geneIndex]++;
+			bits |= 1ull << (i & 63);
+		}
+		world._aliveMask[word].store(bits, std::memory_order_relaxed);
+	}
+
+	for (uint16_t i = 0; i < world._genesCount; i++) {
+		if (world._genes[i].isUsed())
+			world._genes[i].referenceCount = references[i + 1];
+	}
+	return true;
+}
+
+void Snapshot::captureState(World& world, SnapshotBuffer& buffer)
+{
+	buffer.isDelta = false;
+	SnapshotHeader& header = buffer.header;
+	header = {};
+	memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+	header.version = SNAPSHOT_VERSION;
+	header.width = world._width;
+	header.height = world._height;
+	header.seed = world._seed;
+	header.stepCounter = world._stepCounter;
+	header.aliveTilesCounter = world._aliveTilesCounter;
+	header.maxEnergy = world._maxEnergy;
+	writeParameters(world, header.parameters);
+	header.genesCount = world._genesCount;
+	header.freeGeneSlotsCount = static_cast<uint32_t>(world._freeGeneSlots.size());
+
+	buffer.genes.resize(world._genesCount);
+	for (uint16_t i = 0; i < world._genesCount; i++)
+		writeGene(world._genes[i], buffer.genes[i]);
+	//       ,   
+	buffer.freeGeneSlots = world._freeGeneSlots;
+}
+
+std::shared_ptr<SnapshotBuffer> Snapshot::capture(World& world, std::shared_ptr<SnapshotBuffer> previous)
+{
+	TraceScope traceScope("Snapshot capture");
+	TileStorage& tiles = *world._tiles;
+	size_t count = tiles.getCount();
+
+	//       ,   
+	auto buffer = std::move(previous);
+	bool isFull = buffer == nullptr || buffer->isDelta || buffer->capturedEpoch == 0 ||
+		buffer->header.width != static_cast<uint32_t>(world._width) || buffer->header.height != static_cast<uint32_t>(world._height);
+	if (buffer == nullptr)
+		buffer = std::make_shared<SnapshotBuffer>();
+	uint32_t capturedEpoch = buffer->capturedEpoch;
+	captureState(world, *buffer);
+
+	for (int i = 0; i < TileStorage::PERSISTENT_ARRAYS_COUNT; i++) {
+		const uint8_t* data = static_cast<const uint8_t*>(tiles.getArray(i));
+		std::vector<uint8_t>& array = buffer->arrays[i];
+		if (isFull) {
+			array.assign(data, data + tiles.getArraySize(i));
+			continue;
+		}
+
+		size_t elementSize = TileStorage::getElementSize(i);
+		for (size_t chunk = 0; chunk < world._aliveMaskSize; chunk++) {
+			if (world._tileChangeStamps[chunk].load(std::memory_order_relaxed) <= capturedEpoch)
+				continue;
+			size_t begin = chunk * DELTA_CHUNK_SIZE;
+			size_t end = std::min(begin + DELTA_CHUNK_SIZE, count);
+			memcpy(array.data() + begin * elementSize, data + begin * elementSize, (end - begin) * elementSize);
+		}
+	}
+	buffer->capturedEpoch = world.beginChangeEpoch();
+
+	return buffer;
+}
+
+bool Snapshot::write(SnapshotBuffer& buffer, const std::string& path)
+{
+	TraceScope traceScope("Snapshot write");
+	//        .       
+	//    ,        
+	std::string tempPath = path + ".tmp";
+	std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+	if (!file)
+		return false;
+
+	if (buffer.isDelta)
+		writeDelta(buffer, file);
+	else
+		writeFull(buffer, file);
+
+	file.close();
+	if (!file) {
+		remove(tempPath.c_str());
+		return false;
+	}
+	return replaceFile(tempPath, path);
+}
+
+bool Snapshot::save(World& world, const std::string& path)
+{
+	//      ,         
+	SnapshotBuffer buffer;
+	captureState(world, buffer);
+	buffer.tiles = world._tiles.get();
+	return write(buffer, path);
+}
+
+void Snapshot::writeFull(SnapshotBuffer& buffer, std::ofstream& file)
+{
+	SnapshotHeader& header = buffer.header;
+
+	const void* sections[SNAPSHOT_SECTIONS_COUNT];
+	for (int i = 0; i < TileStorage::PERSISTENT_ARRAYS_COUNT; i++) {
+		sections[i] = buffer.tiles != nullptr ? buffer.tiles->getArray(i) : buffer.arrays[i].data();
+		header.sectionSizes[i] = buffer.tiles != nullptr ? buffer.tiles->getArraySize(i) : buffer.arrays[i].size();
+	}
+	sections[SNAPSHOT_SECTION_GENES] = buffer.genes.data();
+	header.sectionSizes[SNAPSHOT_SECTION_GENES] = buffer.genes.size() * sizeof(SnapshotGene);
+	sections[SNAPSHOT_SECTION_FREE_GENE_SLOTS] = buffer.freeGeneSlots.data();
+	header.sectionSizes[SNAPSHOT_SECTION_FREE_GENE_SLOTS] = buffer.freeGeneSlots.size() * sizeof(uint16_t);
+
+	uint64_t offset = alignSection(sizeof(header));
+	for (int i = 0; i < SNAPSHOT_SECTIONS_COUNT; i++) {
+		header.sectionOffsets[i] = offset;
+		offset = alignSection(offset + header.sectionSizes[i]);
+	}
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	uint64_t position = sizeof(header);
+	for (int i = 0; i < SNAPSHOT_SECTIONS_COUNT; i++) {
+		writePadding(file, position, header.sectionOffsets[i]);
+		file.write(static_cast<const char*>(sections[i]), static_cast<std::streamsize>(header.sectionSizes[i]));
+		position += header.sectionSizes[i];
+	}
+	writePadding(file, position, offset);
+}
+
+std::unique_ptr<World> Snapshot::load(const std::string& path)
+{
+	auto file = std::make_unique<MappedFile>();
+	if (!file->open(path) || file->getSize() < sizeof(SnapshotHeader))
+		return nullptr;
+
+	SnapshotHeader header;
+	memcpy(&header, file->getData(), sizeof(header));
+	if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 || header.version != SNAPSHOT_VERSION)
+		return nullptr;
+	if (header.width == 0 || header.width > UINT16_MAX || header.height == 0 || header.height > UINT16_MAX)
+		return nullptr;
+	if (header.genesCount > MAX_GENES_COUNT || header.freeGeneSlotsCount > header.genesCount)
+		return nullptr;
+
+	// ,   ,       
+	size_t count = static_cast<size_t>(header.width) * header.height;
+	uint64_t expectedSizes[SNAPSHOT_SECTIONS_COUNT];
+	for (int i = 0; i < TileStorage::PERSISTENT_ARRAYS_COUNT; i++)
+		expectedSizes[i] = static_cast<uint64_t>(count) * TileStorage::getElementSize(i);
+	expectedSizes[SNAPSHOT_SECTION_GENES] = static_cast<uint64_t>(header.genesCount) * sizeof(SnapshotGene);
+	expectedSizes[SNAPSHOT_SECTION_FREE_GENE_SLOTS] = static_cast<uint64_t>(header.freeGeneSlotsCount) * sizeof(uint16_t);
+	for (int i = 0; i < SNAPSHOT_SECTIONS_COUNT; i++) {
+		if (header.sectionSizes[i] != expectedSizes[i] || header.sectionOffsets[i] % SNAPSHOT_SECTION_ALIGNMENT != 0)
+			return nullptr;
+		if (header.sectionOffsets[i] > file->getSize() || header.sectionSizes[i] > file->getSize() - header.sectionOffsets[i])
+			return nullptr;
+	}
+
+	//   ,     
+	//      ,  memcpy    -  
+	std::vector<SnapshotGene> genes(header.genesCount);
+	if (!genes.empty())
+		memcpy(genes.data(), file->getData() + header.sectionOffsets[SNAPSHOT_SECTION_GENES], header.sectionSizes[SNAPSHOT_SECTION_GENES]);
+	std::vector<uint16_t> freeGeneSlots(header.freeGeneSlotsCount);
+	if (!freeGeneSlots.empty())
+		memcpy(freeGeneSlots.data(), file->getData() + header.sectionOffsets[SNAPSHOT_SECTION_FREE_GENE_SLOTS], header.sectionSizes[SNAPSHOT_SECTION_FREE_GENE_SLOTS]);
+
+	//      ,      
+	auto tiles = std::make_unique<TileStorage>(count, std::move(file), header.sectionOffsets);
+	std::unique_ptr<World> world(new World(static_cast<uint16_t>(header.width), static_cast<uint16_t>(header.height), std::move(tiles)));
+	world->_seed = header.seed;
+	world->_stepCounter = header.stepCounter;
+	world->_aliveTilesCounter = header.aliveTilesCounter;
+	world->_maxEnergy = header.maxEnergy;
+	readParameters(*world, header.parameters);
+	world->_freeGeneSlots = std::move(freeGeneSlots);
+
+	world->_genesCount = static_cast<uint16_t>(header.genesCount);
+	for (uint16_t i = 0; i < world->_genesCount; i++) {
+		if (genes[i].index != 0 && genes[i].index != i + 1)
+			return nullptr;
+		readGene(world->_genes[i], genes[i]);
+	}
+	for (uint16_t slot : world->_freeGeneSlots) {
+		if (slot >= world->_genesCount || world->_genes[slot].isUsed())
+			return nullptr;
+	}
+
+	if (!rebuildTileState(*world))
+		return nullptr;
+	return world;
+}
+
+std::shared_ptr<SnapshotBuffer> Snapshot::captureDelta(World& world, uint32_t fromStep, uint32_t sinceEpoch)
+{
+	TraceScope traceScope("Snapshot delta capture");
+	TileStorage& tiles = *world._tiles;
+	size_t count = tiles.getCount();
+	auto buffer = std::make_shared<SnapshotBuffer>();
+	buffer->isDelta = true;
+
+	//  ,    sinceEpoch
+	for (uint16_t i = 0; i < MAX_GENES_COUNT; i++) {
+		if (world._geneChangeStamps[i] <= sinceEpoch)
+			continue;
+		buffer->changedSlots.push_back(i);
+		buffer->genes.emplace_back();
+		writeGene(world._genes[i], buffer->genes.back());
+	}
+	buffer->freeGeneSlots = world._freeGeneSlots;
+
+	DeltaHeader& header = buffer->deltaHeader;
+	header = {};
+	memcpy(header.magic, DELTA_MAGIC, sizeof(header.magic));
+	header.version = DELTA_VERSION;
+	header.width = world._width;
+	header.height = world._height;
+	header.seed = world._seed;
+	header.fromStep = fromStep;
+	header.toStep = world._stepCounter;
+	header.aliveTilesCounter = world._aliveTilesCounter;
+	header.maxEnergy = world._maxEnergy;
+	writeParameters(world, header.parameters);
+	header.genesCount = world._genesCount;
+	header.freeGeneSlotsCount = static_cast<uint32_t>(world._freeGeneSlots.size());
+	header.changedGenesCount = static_cast<uint32_t>(buffer->changedSlots.size());
+
+	//      .     ,
+	//     
+	size_t chunksCount = world._aliveMaskSize;
+	size_t chunk = 0;
+	while (chunk < chunksCount) {
+		if (world._tileChangeStamps[chunk].load(std::memory_order_relaxed) <= sinceEpoch) {
+			chunk++;
+			continue;
+		}
+		size_t firstChunk = chunk;
+		while (chunk < chunksCount && world._tileChangeStamps[chunk].load(std::memory_order_relaxed) > sinceEpoch)
+			chunk++;
+
+		buffer->ranges.push_back(static_cast<uint32_t>(firstChunk));
+		buffer->ranges.push_back(static_cast<uint32_t>(chunk - firstChunk));
+
+		size_t begin = firstChunk * DELTA_CHUNK_SIZE;
+		size_t end = chunk * DELTA_CHUNK_SIZE < count ? chunk * DELTA_CHUNK_SIZE : count;
+		for (int i = 0; i < TileStorage::PERSISTENT_ARRAYS_COUNT; i++) {
+			size_t elementSize = TileStorage::getElementSize(i);
+			const uint8_t* data = static_cast<const uint8_t*>(tiles.getArray(i));
+			buffer->arrays[i].insert(buffer->arrays[i].end(), data + begin * elementSize, data + end * elementSize);
+		}
+		header.rangesCount++;
+	}
+
+	return buffer;
+}
+
+bool Snapshot::saveDelta(World& world, const std::string& path, uint32_t fromStep, uint32_t sinceEpoch)
+{
+	return write(*captureDelta(world, fromStep, sinceEpoch), path);
+}
+
+void Snapshot::writeDelta(SnapshotBuffer& buffer, std::ofstream& file)
+{
+	DeltaHeader& header = buffer.deltaHeader;
+	size_t count = static_cast<size_t>(header.width) * header.height;
+
+	std::vector<uint8_t> output;
+	append(output, &header, sizeof(header));
+	append(output, buffer.freeGeneSlots.data(), buffer.freeGeneSlots.size() * sizeof(uint16_t));
+	append(output, buffer.changedSlots.data(), buffer.changedSlots.size() * sizeof(uint16_t));
+	append(output, buffer.genes.data(), buffer.genes.size() * sizeof(SnapshotGene));
+
+	std::vector<uint8_t> planes;
+	size_t arrayOffsets[TileStorage::PERSISTENT_ARRAYS_COUNT] = {};
+	for (size_t n = 0; n < buffer.ranges.size(); n += 2) {
+		append(output, &buffer.ranges[n], 2 * sizeof(uint32_t));
+
+		size_t begin = static_cast<size_t>(buffer.ranges[n]) * DELTA_CHUNK_SIZE;
+		size_t end = (static_cast<size_t>(buffer.ranges[n]) + buffer.ranges[n + 1]) * DELTA_CHUNK_SIZE;
+		if (end > count)
+			end = count;
+
+		for (int i = 0; i < TileStorage::PERSISTENT_ARRAYS_COUNT; i++) {
+			size_t elementSize = TileStorage::getElementSize(i);
+			size_t sizeOffset = output.size();
+			output.resize(sizeOffset + sizeof(uint32_t));
+			packArray(buffer.arrays[i].data() + arrayOffsets[i], end - begin, elementSize, planes, output);
+			arrayOffsets[i] += (end - begin) * elementSize;
+			uint32_t packedSize = static_cast<uint32_t>(output.size() - sizeOffset - sizeof(uint32_t));
+			memcpy(output.data() + sizeOffset, &packedSize, sizeof(packedSize));
+		}
+	}
+
+	file.write(reinterpret_cast<const char*>(output.data()), static_cast<std::streamsize>(output.size()));
+}
+
+bool Snapshot::applyDelta(World& world, const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file)
+		return false;
+	std::vector<uint8_t> input(static_cast<size_t>(file.tellg()));
+	file.seekg(0);
+	if (!file.read(reinterpret_cast<char*>(input.data()), static_cast<std::streamsize>(input.size())))
+		return false;
+
+	DeltaReader reader = { input.data(), input.size(), 0 };
+	DeltaHeader header;
+	if (!reader.read(&header, sizeof(header)))
+		return false;
+	if (memcmp(header.magic, DELTA_MAGIC, sizeof(header.magic)) != 0 || header.version != DELTA_VERSION)
+		return false;
+	if (header.width != static_cast<uint32_t>(world._width) || header.height != static_cast<uint32_t>(world._height))
+		return false;
+	if (header.seed != world._seed || header.fromStep != world._stepCounter)
+		return false;
+	if (header.genesCount > MAX_GENES_COUNT || header.freeGeneSlotsCount > header.genesCount || header.changedGenesCount > MAX_GENES_COUNT)
+		return false;
+
+	std::vector<uint16_t> freeGeneSlots(header.freeGeneSlotsCount);
+	std::vector<uint16_t> changedSlots(header.changedGenesCount);
+	std::vector<SnapshotGene> changedGenes(header.changedGenesCount);
+	if (!reader.read(freeGeneSlots.data(), freeGeneSlots.size() * sizeof(uint16_t)) ||
+		!reader.read(changedSlots.data(), changedSlots.size() * sizeof(uint16_t)) ||
+		!reader.read(changedGenes.data(), changedGenes.size() * sizeof(SnapshotGene)))
+		return false;
+	for (size_t i = 0; i < changedSlots.size(); i++) {
+		if (changedSlots[i] >= MAX_GENES_COUNT || (changedGenes[i].index != 0 && changedGenes[i].index != changedSlots[i] + 1))
+			return false;
+	}
+
+	//    ,      
+	struct Range
+	{
+		size_t begin;
+		size_t end;
+		std::vector<uint8_t> arrays[TileStorage::PERSISTENT_ARRAYS_COUNT];
+	};
+	std::vector<Range> ranges;
+	std::vector<uint8_t> planes;
+	size_t count = world._tiles->getCount();
+	for (uint32_t n = 0; n < header.rangesCount; n++) {
+		uint32_t chunks[2];
+		if (!reader.read(chunks, sizeof(chunks)))
+			return false;
+		if (chunks[1] == 0 || chunks[0] >= world._aliveMaskSize || chunks[1] > world._aliveMaskSize - chunks[0])
+			return false;
+
+		ranges.emplace_back();
+		Range& range = ranges.back();
+		range.begin = static_cast<size_t>(chunks[0]) * DELTA_CHUNK_SIZE;
+		range.end = (static_cast<size_t>(chunks[0]) + chunks[1]) * DELTA_CHUNK_SIZE;
+		if (range.end > count)
+			range.end = count;
+
+		for (int i = 0; i < TileStorage::PERSISTENT_ARRAYS_COUNT; i++) {
+			uint32_t packedSize;
+			if (!reader.read(&packedSize, sizeof(packedSize)) || packedSize > reader.size - reader.position)
+				return false;
+			size_t elementSize = TileStorage::getElementSize(i);
+			range.arrays[i].resize((range.end - range.begin) * elementSize);
+			if (!unpackArray(reader.data + reader.position, packedSize, range.end - range.begin, elementSize, planes, range.arrays[i].data()))
+				return false;
+			reader.position += packedSize;
+		}
+	}
+
+	//       ,      
+	std::vector<uint8_t> isUsed(MAX_GENES_COUNT);
+	for (uint16_t i = 0; i < world._genesCount; i++)
+		isUsed[i] = world._genes[i].isUsed();
+	for (size_t i = 0; i < changedSlots.size(); i++)
+		isUsed[changedSlots[i]] = changedGenes[i].index != 0;
+	for (uint32_t i = header.genesCount; i < MAX_GENES_COUNT; i++) {
+		if (isUsed[i])
+			return false;
+	}
+	for (uint16_t slot : freeGeneSlots) {
+		if (slot >= header.genesCount || isUsed[slot])
+			return false;
+	}
+	//    :         ,   
+	std::vector<uint8_t> isChangedChunk(world._aliveMaskSize);
+	for (Range& range : ranges) {
+		const uint16_t* geneIndices = reinterpret_cast<const uint16_t*>(range.arrays[TileStorage::ARRAY_GENE_INDEX].data());
+		for (size_t i = 0; i < range.end - range.begin; i++) {
+			if (geneIndices[i] != 0 && !isUsed[geneIndices[i] - 1])
+				return false;
+		}
+		std::fill(isChangedChunk.begin() + range.begin / DELTA_CHUNK_SIZE, isChangedChunk.begin() + (range.end + DELTA_CHUNK_SIZE - 1) / DELTA_CHUNK_SIZE, 1);
+	}
+	const uint16_t* worldGeneIndices = world._tiles->geneIndex;
+	for (size_t chunk = 0; chunk < world._aliveMaskSize; chunk++) {
+		if (isChangedChunk[chunk])
+			continue;
+		size_t end = std::min(count, (chunk + 1) * DELTA_CHUNK_SIZE);
+		for (size_t i = chunk * DELTA_CHUNK_SIZE; i < end; i++) {
+			if (worldGeneIndices[i] != 0 && !isUsed[worldGeneIndices[i] - 1])
+				return false;
+		}
+	}
+
+	//  
+	TileStorage& tiles = *world._tiles;
+	for (Range& range : ranges) {
+		for (int i = 0; i < TileStorage::PERSISTENT_ARRAYS_COUNT; i++) {
+			size_t elementSize = TileStorage::getElementSize(i);
+			memcpy(static_cast<uint8_t*>(tiles.getArray(i)) + range.begin * elementSize, range.arrays[i].data(), range.arrays[i].size());
+		}
+	}
+	for (size_t i = 0; i < changedSlots.size(); i++)
+		readGene(world._genes[changedSlots[i]], changedGenes[i]);
+	world._genesCount = static_cast<uint16_t>(header.genesCount);
+	world._freeGeneSlots = std::move(freeGeneSlots);
+
+	world._stepCounter = header.toStep;
+	world._aliveTilesCounter = header.aliveTilesCounter;
+	world._maxEnergy = header.maxEnergy;
+	readParameters(world, header.parameters);
+
+	return rebuildTileState(world);
+}
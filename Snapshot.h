@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdint.h>
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+class World;
+class Gene;
+struct SnapshotGene;
+struct SnapshotParameters;
+struct SnapshotBuffer;
+
+//    : ,  ,  ,
+//     .      .
+//         ,    .
+//        (capture)       (write)
+class Snapshot
+{
+public:
+	//      .      
+	//   ,    ,      , 
+	//   .    ,   4096x4096  0.3-0.5 
+	static std::shared_ptr<SnapshotBuffer> capture(World& world, std::shared_ptr<SnapshotBuffer> previous = nullptr);
+	//      , . saveDelta
+	static std::shared_ptr<SnapshotBuffer> captureDelta(World& world, uint32_t fromStep, uint32_t sinceEpoch);
+	//       .  false   
+	static bool write(SnapshotBuffer& buffer, const std::string& path);
+
+	//    .  false   
+	static bool save(World& world, const std::string& path);
+	//    .  nullptr,     
+	static std::unique_ptr<World> load(const std::string& path);
+
+	//   ,     sinceEpoch (. World::beginChangeEpoch),
+	//       fromStep.  false   
+	static bool saveDelta(World& world, const std::string& path, uint32_t fromStep, uint32_t sinceEpoch);
+	//     ,   ,    .
+	//  false,        .      
+	static bool applyDelta(World& world, const std::string& path);
+
+private:
+	//  ,      
+	static void captureState(World& world, SnapshotBuffer& buffer);
+	static void writeParameters(World& world, SnapshotParameters& parameters);
+	static void readParameters(World& world, const SnapshotParameters& parameters);
+	static void writeGene(Gene& gene, SnapshotGene& record);
+	static void readGene(Gene& gene, const SnapshotGene& record);
+	static void writeFull(SnapshotBuffer& buffer, std::ofstream& file);
+	static void writeDelta(SnapshotBuffer& buffer, std::ofstream& file);
+	//          .
+	//  false,      
+	static bool rebuildTileState(World& world);
+};
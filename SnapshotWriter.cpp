@@ -0,0 +1,79 @@
+#include "SnapshotWriter.h"
+#include "Snapshot.h"
+#include "Trace.h"
+
+SnapshotWriter::SnapshotWriter()
+{
+	_thread = std::thread(&SnapshotWriter::threadLoop, this);
+}
+
+SnapshotWriter::~SnapshotWriter()
+{
+	// ,    ,   
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_isStopping = true;
+	}
+	_queueCondition.notify_all();
+	_thread.join();
+}
+
+void SnapshotWriter::write(std::shared_ptr<SnapshotBuffer> buffer, const std::string& path)
+{
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_doneCondition.wait(lock, [this] { return _queue.size() < MAX_PENDING_COUNT; });
+		_queue.emplace_back(std::move(buffer), path);
+	}
+	_queueCondition.notify_one();
+}
+
+void SnapshotWriter::flush()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_doneCondition.wait(lock, [this] { return _queue.empty() && !_isWriting; });
+}
+
+bool SnapshotWriter::isBusy()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return !_queue.empty() || _isWriting;
+}
+
+unsigned SnapshotWriter::getFailedCount()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _failedCount;
+}
+
+void SnapshotWriter::threadLoop()
+{
+	Trace::setThreadName("Snapshot writer");
+	while (true) {
+		std::shared_ptr<SnapshotBuffer> buffer;
+		std::string path;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_queueCondition.wait(lock, [this] { return _isStopping || !_queue.empty(); });
+			if (_queue.empty())
+				return;
+			buffer = std::move(_queue.front().first);
+			path = std::move(_queue.front().second);
+			_queue.pop_front();
+			_isWriting = true;
+		}
+		//    
+		_doneCondition.notify_all();
+
+		bool isWritten = Snapshot::write(*buffer, path);
+		buffer.reset();
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_isWriting = false;
+			if (!isWritten)
+				_failedCount++;
+		}
+		_doneCondition.notify_all();
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+struct SnapshotBuffer;
+
+//   .        (Snapshot::capture),
+//          ,   .
+//    , write ,      
+class SnapshotWriter
+{
+public:
+	SnapshotWriter();
+	~SnapshotWriter();
+
+	SnapshotWriter(const SnapshotWriter&) = delete;
+	SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+	//         path
+	void write(std::shared_ptr<SnapshotBuffer> buffer, const std::string& path);
+	//      
+	void flush();
+
+	//   ,    
+	bool isBusy();
+	//  ,    
+	unsigned getFailedCount();
+
+private:
+	//          
+	static const size_t MAX_PENDING_COUNT = 2;
+
+	std::thread _thread;
+	std::mutex _mutex;
+	std::condition_variable _queueCondition;
+	std::condition_variable _doneCondition;
+
+	std::deque<std::pair<std::shared_ptr<SnapshotBuffer>, std::string>> _queue;
+	//    ,    
+	bool _isWriting = false;
+	unsigned _failedCount = 0;
+	bool _isStopping = false;
+
+	void threadLoop();
+};
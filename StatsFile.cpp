@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include <string.h>
+#include "StatsHistory.h"
+#include "StatsFile.h"
+
+#define STATS_MAGIC		"SIMS"
+#define STATS_VERSION	1
+
+//   .     ,   StepStats  
+struct StatsFileHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t recordSize;
+	uint32_t reserved;
+};
+
+StatsFile::StatsFile()
+{
+	_isText = false;
+	_nextNumber = 0;
+	_lostCount = 0;
+}
+
+StatsFile::~StatsFile()
+{
+	close();
+}
+
+bool StatsFile::open(StatsHistory& history, const std::string& path)
+{
+	close();
+
+	_isText = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+	_file.open(path, std::ios::out | std::ios::trunc | (_isText ? std::ios::openmode() : std::ios::binary));
+	if (!_file)
+		return false;
+
+	if (_isText) {
+		_file << "step,alive,plants,predators,total_energy,mean_energy,max_energy,genes,births,deaths,mutations,moves\n";
+	} else {
+		StatsFileHeader header = {};
+		memcpy(header.magic, STATS_MAGIC, sizeof(header.magic));
+		header.version = STATS_VERSION;
+		header.recordSize = sizeof(StepStats);
+		_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	}
+
+	_nextNumber = history.getTotalCount();
+	_lostCount = 0;
+	return static_cast<bool>(_file);
+}
+
+void StatsFile::close()
+{
+	if (_file.is_open())
+		_file.close();
+}
+
+bool StatsFile::isOpened()
+{
+	return _file.is_open();
+}
+
+bool StatsFile::write(StatsHistory& history)
+{
+	if (!_file.is_open())
+		return false;
+
+	uint64_t totalCount = history.getTotalCount();
+	uint64_t firstNumber = totalCount - history.getCount();
+	if (_nextNumber < firstNumber) {
+		_lostCount += firstNumber - _nextNumber;
+		_nextNumber = firstNumber;
+	}
+
+	char line[256];
+	for (; _nextNumber < totalCount; _nextNumber++) {
+		const StepStats& stats = history.get(_nextNumber);
+		if (!_isText) {
+			_file.write(reinterpret_cast<const char*>(&stats), sizeof(stats));
+			continue;
+		}
+		float meanEnergy = stats.aliveTilesCount > 0 ? stats.totalEnergy / stats.aliveTilesCount : 0.0f;
+		snprintf(line, sizeof(line), "%u,%u,%u,%u,%.4f,%.6f,%.6f,%u,%u,%u,%u,%u\n",
+			stats.step, stats.aliveTilesCount, stats.plantsCount, stats.predatorsCount,
+			stats.totalEnergy, meanEnergy, stats.maxEnergy, stats.genesCount,
+			stats.birthsCount, stats.deathsCount, stats.mutationsCount, stats.movesCount);
+		_file << line;
+	}
+	_file.flush();
+	return static_cast<bool>(_file);
+}
+
+uint64_t StatsFile::getLostCount()
+{
+	return _lostCount;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdint.h>
+#include <fstream>
+#include <string>
+
+class StatsHistory;
+
+//          .    .csv  
+//   ,  - :    StepStats 
+class StatsFile
+{
+public:
+	StatsFile();
+	~StatsFile();
+
+	StatsFile(const StatsFile&) = delete;
+	StatsFile& operator=(const StatsFile&) = delete;
+
+	//       ,      .
+	//  false,     
+	bool open(StatsHistory& history, const std::string& path);
+	void close();
+	bool isOpened();
+
+	//   ,    . ,   
+	//  , ,    ,    STATS_HISTORY_SIZE .
+	//  false   
+	bool write(StatsHistory& history);
+	//  ,  -  
+	uint64_t getLostCount();
+
+private:
+	std::ofstream _file;
+	bool _isText;
+	//      , . StatsHistory::get
+	uint64_t _nextNumber;
+	uint64_t _lostCount;
+};
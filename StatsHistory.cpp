@@ -0,0 +1,33 @@
+#include <algorithm>
+#include "StatsHistory.h"
+
+StatsHistory::StatsHistory()
+{
+	_stats = std::make_unique<StepStats[]>(STATS_HISTORY_SIZE);
+}
+
+void StatsHistory::add(const StepStats& stats)
+{
+	_stats[_totalCount % STATS_HISTORY_SIZE] = stats;
+	_totalCount++;
+}
+
+uint32_t StatsHistory::getCount()
+{
+	return static_cast<uint32_t>(std::min<uint64_t>(_totalCount, STATS_HISTORY_SIZE));
+}
+
+uint64_t StatsHistory::getTotalCount()
+{
+	return _totalCount;
+}
+
+const StepStats& StatsHistory::get(uint64_t number)
+{
+	return _stats[number % STATS_HISTORY_SIZE];
+}
+
+const StepStats& StatsHistory::getLast()
+{
+	return get(_totalCount - 1);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+
+//   ,    
+#define STATS_HISTORY_SIZE		4096
+
+//    .     ,    .
+//    4 ,       
+struct StepStats
+{
+	//  ,    
+	uint32_t step;
+	//    
+	uint32_t aliveTilesCount;
+	//         ,     .
+	// ,    World::countLifeForms,   0
+	uint32_t plantsCount;
+	uint32_t predatorsCount;
+	float totalEnergy;
+	float maxEnergy;
+	uint32_t genesCount;
+	uint32_t birthsCount;
+	// ,   , ,       
+	uint32_t deathsCount;
+	uint32_t mutationsCount;
+	uint32_t movesCount;
+};
+
+//     .      ,
+//       
+class StatsHistory
+{
+public:
+	StatsHistory();
+
+	void add(const StepStats& stats);
+
+	//   ,   STATS_HISTORY_SIZE
+	uint32_t getCount();
+	//  ,    
+	uint64_t getTotalCount();
+	//     number.     getTotalCount() - getCount()  getTotalCount() - 1
+	const StepStats& get(uint64_t number);
+	//   .     
+	const StepStats& getLast();
+
+private:
+	std::unique_ptr<StepStats[]> _stats;
+	uint64_t _totalCount = 0;
+};
@@ -0,0 +1,92 @@
+#include <string>
+#include "Trace.h"
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(unsigned threadsCount)
+{
+	_nextTask = 0;
+	for (unsigned i = 1; i < threadsCount; i++) {
+		_threads.emplace_back(&ThreadPool::threadLoop, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_isStopping = true;
+	}
+	_startCondition.notify_all();
+
+	for (auto& thread : _threads)
+		thread.join();
+}
+
+unsigned ThreadPool::getThreadsCount()
+{
+	return static_cast<unsigned>(_threads.size() + 1);
+}
+
+void ThreadPool::run(size_t tasksCount, const std::function<void(size_t)>& task)
+{
+	if (tasksCount == 0)
+		return;
+
+	//            
+	if (_threads.empty() || tasksCount == 1) {
+		for (size_t i = 0; i < tasksCount; i++) {
+			TraceScope traceScope("Task");
+			task(i);
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_task = &task;
+		_tasksCount = tasksCount;
+		_nextTask = 0;
+		_activeThreads = static_cast<unsigned>(_threads.size());
+		_generation++;
+	}
+	_startCondition.notify_all();
+
+	runTasks();
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_finishCondition.wait(lock, [this] { return _activeThreads == 0; });
+	_task = nullptr;
+}
+
+void ThreadPool::threadLoop(unsigned index)
+{
+	Trace::setThreadName("Worker " + std::to_string(index));
+	uint64_t generation = 0;
+
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_startCondition.wait(lock, [&] { return _isStopping || _generation != generation; });
+			if (_isStopping)
+				return;
+			generation = _generation;
+		}
+
+		runTasks();
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (--_activeThreads == 0)
+			_finishCondition.notify_one();
+	}
+}
+
+void ThreadPool::runTasks()
+{
+	while (true) {
+		size_t index = _nextTask.fetch_add(1);
+		if (index >= _tasksCount)
+			break;
+		TraceScope traceScope("Task");
+		(*_task)(index);
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//      .
+//     ,         
+class ThreadPool
+{
+public:
+	ThreadPool(unsigned threadsCount);
+	~ThreadPool();
+
+	unsigned getThreadsCount();
+
+	//      0  tasksCount - 1.      
+	void run(size_t tasksCount, const std::function<void(size_t)>& task);
+
+private:
+	std::vector<std::thread> _threads;
+	std::mutex _mutex;
+	std::condition_variable _startCondition;
+	std::condition_variable _finishCondition;
+
+	//   
+	const std::function<void(size_t)>* _task = nullptr;
+	size_t _tasksCount = 0;
+	std::atomic<size_t> _nextTask;
+
+	//    . ,       
+	uint64_t _generation = 0;
+	//  ,     
+	unsigned _activeThreads = 0;
+	bool _isStopping = false;
+
+	//      index,   1
+	void threadLoop(unsigned index);
+	void runTasks();
+};
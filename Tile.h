@@ -1,7 +1,7 @@
 #pragma once
 
 #include <stdint.h>
-#include <SFML/Graphics.hpp>
+#include "Vector2.h"
 
 //   
 #define DIRECTION_UP			0
@@ -15,23 +15,24 @@
 #define DIRECTIONS_COUNT		8
 
 //     
-const sf::Vector2i DIRECTION_VECTORS[8] = {
-	sf::Vector2i(0, -1),
-	sf::Vector2i(-1, -1),
-	sf::Vector2i(-1, 0),
-	sf::Vector2i(-1, 1),
-	sf::Vector2i(0, 1),
-	sf::Vector2i(1, 1),
-	sf::Vector2i(1, 0),
-	sf::Vector2i(1, -1),
+const Vector2i DIRECTION_VECTORS[8] = {
+	Vector2i(0, -1),
+	Vector2i(-1, -1),
+	Vector2i(-1, 0),
+	Vector2i(-1, 1),
+	Vector2i(0, 1),
+	Vector2i(1, 1),
+	Vector2i(1, 0),
+	Vector2i(1, -1),
 };
 
 //    
-const char* DIRECTION_NAMES[];
+extern const char* DIRECTION_NAMES[];
 
 class World;
 
-//   
+//   .        (TileStorage),
+//          
 class Tile
 {
 public:
@@ -55,7 +56,4 @@ public:
 
 	//   
 	uint8_t commandsCounter = 0;
-
-	//    
-	bool wasProcessed = false;
 };
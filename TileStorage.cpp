@@ -0,0 +1,168 @@
+#include <string.h>
+#include "MappedFile.h"
+#include "TileStorage.h"
+
+//       
+#define TILE_STORAGE_ALIGNMENT	64
+
+static size_t alignSize(size_t size)
+{
+	return (size + TILE_STORAGE_ALIGNMENT - 1) & ~static_cast<size_t>(TILE_STORAGE_ALIGNMENT - 1);
+}
+
+//     
+static const size_t ARRAY_ELEMENT_SIZES[TileStorage::PERSISTENT_ARRAYS_COUNT] = {
+	sizeof(float),
+	sizeof(uint16_t),
+	sizeof(uint8_t),
+	sizeof(uint8_t),
+	sizeof(uint32_t),
+	sizeof(uint32_t),
+	sizeof(float)
+};
+
+TileStorage::TileStorage(size_t count)
+{
+	_count = count;
+
+	size_t totalSize = TILE_STORAGE_ALIGNMENT + alignSize(count * sizeof(uint32_t));
+	for (int i = 0; i < PERSISTENT_ARRAYS_COUNT; i++)
+		totalSize += alignSize(getArraySize(i));
+
+	//        
+	_buffer = std::make_unique<uint8_t[]>(totalSize);
+	memset(_buffer.get(), 0, totalSize);
+
+	uint8_t* ptr = reinterpret_cast<uint8_t*>(alignSize(reinterpret_cast<size_t>(_buffer.get())));
+	for (int i = 0; i < PERSISTENT_ARRAYS_COUNT; i++) {
+		setArray(i, ptr);
+		ptr += alignSize(getArraySize(i));
+	}
+	processedStamp = reinterpret_cast<uint32_t*>(ptr);
+}
+
+TileStorage::TileStorage(size_t count, std::unique_ptr<MappedFile> file, const uint64_t* offsets)
+{
+	_count = count;
+	_file = std::move(file);
+
+	//     ,    
+	size_t totalSize = TILE_STORAGE_ALIGNMENT + alignSize(count * sizeof(uint32_t));
+	_buffer = std::make_unique<uint8_t[]>(totalSize);
+	memset(_buffer.get(), 0, totalSize);
+	processedStamp = reinterpret_cast<uint32_t*>(alignSize(reinterpret_cast<size_t>(_buffer.get())));
+
+	for (int i = 0; i < PERSISTENT_ARRAYS_COUNT; i++)
+		setArray(i, _file->getData() + offsets[i]);
+}
+
+TileStorage::~TileStorage()
+{
+}
+
+size_t TileStorage::getCount()
+{
+	return _count;
+}
+
+void* TileStorage::getArray(int array)
+{
+	switch (array)
+	{
+	case ARRAY_ENERGY:
+		return energy;
+	case ARRAY_GENE_INDEX:
+		return geneIndex;
+	case ARRAY_DIRECTION:
+		return direction;
+	case ARRAY_COMMANDS_COUNTER:
+		return commandsCounter;
+	case ARRAY_EATEN_FOOD_COUNT:
+		return eatenFoodCount;
+	case ARRAY_PHOTOSYNTH_COUNT:
+		return photosynthCount;
+	case ARRAY_TEMP:
+		return temp;
+	default:
+		return nullptr;
+	}
+}
+
+size_t TileStorage::getArraySize(int array)
+{
+	return _count * ARRAY_ELEMENT_SIZES[array];
+}
+
+size_t TileStorage::getElementSize(int array)
+{
+	return ARRAY_ELEMENT_SIZES[array];
+}
+
+void TileStorage::setArray(int array, uint8_t* data)
+{
+	switch (array)
+	{
+	case ARRAY_ENERGY:
+		energy = reinterpret_cast<float*>(data);
+		break;
+	case ARRAY_GENE_INDEX:
+		geneIndex = reinterpret_cast<uint16_t*>(data);
+		break;
+	case ARRAY_DIRECTION:
+		direction = data;
+		break;
+	case ARRAY_COMMANDS_COUNTER:
+		commandsCounter = data;
+		break;
+	case ARRAY_EATEN_FOOD_COUNT:
+		eatenFoodCount = reinterpret_cast<uint32_t*>(data);
+		break;
+	case ARRAY_PHOTOSYNTH_COUNT:
+		photosynthCount = reinterpret_cast<uint32_t*>(data);
+		break;
+	case ARRAY_TEMP:
+		temp = reinterpret_cast<float*>(data);
+		break;
+	}
+}
+
+Tile TileStorage::get(size_t index)
+{
+	Tile tile;
+	tile.temp = temp[index];
+	tile.energy = energy[index];
+	tile.eatenFoodCount = eatenFoodCount[index];
+	tile.photosynthCount = photosynthCount[index];
+	tile.geneIndex = geneIndex[index];
+	tile.direction = direction[index];
+	tile.commandsCounter = commandsCounter[index];
+	return tile;
+}
+
+void TileStorage::set(size_t index, const Tile& tile)
+{
+	temp[index] = tile.temp;
+	energy[index] = tile.energy;
+	eatenFoodCount[index] = tile.eatenFoodCount;
+	photosynthCount[index] = tile.photosynthCount;
+	geneIndex[index] = tile.geneIndex;
+	direction[index] = tile.direction;
+	commandsCounter[index] = tile.commandsCounter;
+}
+
+void TileStorage::copy(size_t from, size_t to)
+{
+	temp[to] = temp[from];
+	energy[to] = energy[from];
+	eatenFoodCount[to] = eatenFoodCount[from];
+	photosynthCount[to] = photosynthCount[from];
+	geneIndex[to] = geneIndex[from];
+	direction[to] = direction[from];
+	commandsCounter[to] = commandsCounter[from];
+	processedStamp[to] = processedStamp[from];
+}
+
+void TileStorage::clearProcessedStamps()
+{
+	memset(processedStamp, 0, _count * sizeof(uint32_t));
+}
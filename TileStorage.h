@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <memory>
+#include "Tile.h"
+
+class MappedFile;
+
+//      .       ,
+//         ,   
+class TileStorage
+{
+public:
+	// ,     .      
+	enum PersistentArray
+	{
+		ARRAY_ENERGY,
+		ARRAY_GENE_INDEX,
+		ARRAY_DIRECTION,
+		ARRAY_COMMANDS_COUNTER,
+		ARRAY_EATEN_FOOD_COUNT,
+		ARRAY_PHOTOSYNTH_COUNT,
+		ARRAY_TEMP,
+		PERSISTENT_ARRAYS_COUNT
+	};
+
+	TileStorage(size_t count);
+	// ,          .
+	//    ,   -   
+	TileStorage(size_t count, std::unique_ptr<MappedFile> file, const uint64_t* offsets);
+	~TileStorage();
+
+	float* energy;
+	uint16_t* geneIndex;
+	uint8_t* direction;
+	uint8_t* commandsCounter;
+	uint32_t* eatenFoodCount;
+	uint32_t* photosynthCount;
+	float* temp;
+	//  ,      
+	uint32_t* processedStamp;
+
+	size_t getCount();
+
+	//         
+	void* getArray(int array);
+	size_t getArraySize(int array);
+	//     
+	static size_t getElementSize(int array);
+
+	//   
+	Tile get(size_t index);
+	//   
+	void set(size_t index, const Tile& tile);
+	//       
+	void copy(size_t from, size_t to);
+	//      
+	void clearProcessedStamps();
+
+private:
+	size_t _count;
+	std::unique_ptr<uint8_t[]> _buffer;
+	std::unique_ptr<MappedFile> _file;
+
+	void setArray(int array, uint8_t* data);
+};
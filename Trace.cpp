@@ -0,0 +1,131 @@
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Trace.h"
+
+//   ,    .  
+#define TRACE_RING_SIZE		(1 << 16)
+
+struct TraceEvent
+{
+	const char* name;
+	int64_t start;
+	int64_t end;
+};
+
+//     .    ,     .
+//       ,    
+struct TraceRing
+{
+	std::unique_ptr<TraceEvent[]> events = std::make_unique<TraceEvent[]>(TRACE_RING_SIZE);
+	std::atomic<uint64_t> count = { 0 };
+	//   .    
+	std::atomic<bool> isWriting = { false };
+	std::string threadName;
+	int threadId = 0;
+};
+
+std::atomic<bool> Trace::_isEnabled = { false };
+
+//   ,  - .    ,
+//        
+static std::mutex ringsMutex;
+static std::vector<std::unique_ptr<TraceRing>> rings;
+static std::atomic<int64_t> traceStart = { 0 };
+
+static thread_local TraceRing* threadRing = nullptr;
+static thread_local std::string threadName;
+
+static TraceRing* getThreadRing()
+{
+	if (threadRing == nullptr) {
+		auto ring = std::make_unique<TraceRing>();
+		ring->threadName = threadName;
+		std::lock_guard<std::mutex> lock(ringsMutex);
+		ring->threadId = static_cast<int>(rings.size()) + 1;
+		threadRing = ring.get();
+		rings.push_back(std::move(ring));
+	}
+	return threadRing;
+}
+
+void Trace::start()
+{
+	//    ,       ,
+	//  ,    ,   
+	traceStart.store(now(), std::memory_order_relaxed);
+	_isEnabled.store(true, std::memory_order_release);
+}
+
+bool Trace::stop(const std::string& path)
+{
+	_isEnabled.store(false);
+	int64_t start = traceStart.load(std::memory_order_relaxed);
+
+	std::ofstream file(path, std::ios::out | std::ios::trunc);
+	if (!file)
+		return false;
+
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	bool isFirst = true;
+	char line[256];
+
+	std::lock_guard<std::mutex> lock(ringsMutex);
+	for (auto& ring : rings) {
+		//      ,   
+		//           
+		while (ring->isWriting.load())
+			std::this_thread::yield();
+
+		std::string name = ring->threadName.empty() ? "Thread " + std::to_string(ring->threadId) : ring->threadName;
+		snprintf(line, sizeof(line), "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%i,\"args\":{\"name\":\"%s\"}}",
+			isFirst ? "" : ",\n", ring->threadId, name.c_str());
+		file << line;
+		isFirst = false;
+
+		uint64_t count = ring->count.load(std::memory_order_relaxed);
+		uint64_t first = count > TRACE_RING_SIZE ? count - TRACE_RING_SIZE : 0;
+		for (uint64_t i = first; i < count; i++) {
+			const TraceEvent& event = ring->events[i & (TRACE_RING_SIZE - 1)];
+			if (event.start < start)
+				continue;
+			snprintf(line, sizeof(line), ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%i,\"ts\":%.3f,\"dur\":%.3f}",
+				event.name, ring->threadId, (event.start - start) / 1000.0, (event.end - event.start) / 1000.0);
+			file << line;
+		}
+	}
+	file << "\n]}\n";
+	return static_cast<bool>(file);
+}
+
+void Trace::setThreadName(const std::string& name)
+{
+	threadName = name;
+	if (threadRing != nullptr) {
+		std::lock_guard<std::mutex> lock(ringsMutex);
+		threadRing->threadName = name;
+	}
+}
+
+int64_t Trace::now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Trace::addEvent(const char* name, int64_t start, int64_t end)
+{
+	//   ,   
+	TraceRing* ring = getThreadRing();
+	ring->isWriting.store(true);
+	if (_isEnabled.load()) {
+		uint64_t index = ring->count.load(std::memory_order_relaxed);
+		ring->events[index & (TRACE_RING_SIZE - 1)] = { name, start, end };
+		ring->count.store(index + 1, std::memory_order_relaxed);
+	}
+	ring->isWriting.store(false, std::memory_order_release);
+}
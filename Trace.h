@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <string>
+
+//     , ,        chrome://tracing  Perfetto.
+//          ,  stop       
+//      Chrome trace.   ,     
+class Trace
+{
+public:
+	//  . ,   ,    
+	static void start();
+	//       .  false   
+	static bool stop(const std::string& path);
+
+	//     ,       
+	static bool isEnabled()
+	{
+		return _isEnabled.load(std::memory_order_relaxed);
+	}
+
+	//      
+	static void setThreadName(const std::string& name);
+	//     std::chrono::steady_clock
+	static int64_t now();
+	//    .      .
+	//     
+	static void addEvent(const char* name, int64_t start, int64_t end);
+
+private:
+	static std::atomic<bool> _isEnabled;
+};
+
+//     
+class TraceScope
+{
+public:
+	TraceScope(const char* name)
+	{
+		_name = Trace::isEnabled() ? name : nullptr;
+		if (_name != nullptr)
+			_start = Trace::now();
+	}
+
+	~TraceScope()
+	{
+		if (_name != nullptr)
+			Trace::addEvent(_name, _start, Trace::now());
+	}
+
+	TraceScope(const TraceScope&) = delete;
+	TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+	const char* _name;
+	int64_t _start = 0;
+};
@@ -1,17 +1,22 @@
 #pragma once
 
-#include "imgui.h"
-#include <SFML/Graphics.hpp>
+#include <stdint.h>
+#include <math.h>
+#include "Color.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 class Utils
 {
 public:
 	//   
-	static sf::Color mixColors(sf::Color a, sf::Color b, float alpha) {
-		sf::Color output;
-		output.r = static_cast<sf::Uint8>(a.r * (1.0f - alpha) + b.r * alpha);
-		output.g = static_cast<sf::Uint8>(a.g * (1.0f - alpha) + b.g * alpha);
-		output.b = static_cast<sf::Uint8>(a.b * (1.0f - alpha) + b.b * alpha);
+	static Color mixColors(Color a, Color b, float alpha) {
+		Color output;
+		output.r = static_cast<uint8_t>(a.r * (1.0f - alpha) + b.r * alpha);
+		output.g = static_cast<uint8_t>(a.g * (1.0f - alpha) + b.g * alpha);
+		output.b = static_cast<uint8_t>(a.b * (1.0f - alpha) + b.b * alpha);
 		return output;
 	}
 
@@ -20,6 +25,24 @@ public:
 		return ((b)+(a) % (b)) % (b);
 	}
 	
+	//    .     
+	static int countTrailingZeros(uint64_t value) {
+#if defined(_MSC_VER) && defined(_WIN64)
+		unsigned long index;
+		_BitScanForward64(&index, value);
+		return static_cast<int>(index);
+#elif defined(_MSC_VER)
+		unsigned long index;
+		if (_BitScanForward(&index, static_cast<unsigned long>(value)))
+			return static_cast<int>(index);
+		_BitScanForward(&index, static_cast<unsigned long>(value >> 32));
+		return static_cast<int>(index) + 32;
+#else
+		return __builtin_ctzll(value);
+#endif
+	}
+
+
 	template<typename T>
 	static T clamp(T x, T min, T max) {
 		if (x > max)
@@ -30,13 +53,32 @@ public:
 			return x;
 	}
 
-	static sf::Color hsvToRgb(float h, float s, float v) {
+	//    HSV  RGB.  ImGui::ColorConvertHSVtoRGB
+	static Color hsvToRgb(float h, float s, float v) {
 		float r, g, b;
-		ImGui::ColorConvertHSVtoRGB(h, s, v, r, g, b);
-		return sf::Color(
-			static_cast<sf::Uint8>(r),
-			static_cast<sf::Uint8>(g),
-			static_cast<sf::Uint8>(b)
+		if (s == 0.0f) {
+			r = g = b = v;
+		} else {
+			h = fmodf(h, 1.0f) / (60.0f / 360.0f);
+			int i = static_cast<int>(h);
+			float f = h - static_cast<float>(i);
+			float p = v * (1.0f - s);
+			float q = v * (1.0f - s * f);
+			float t = v * (1.0f - s * (1.0f - f));
+
+			switch (i) {
+			case 0: r = v; g = t; b = p; break;
+			case 1: r = q; g = v; b = p; break;
+			case 2: r = p; g = v; b = t; break;
+			case 3: r = p; g = q; b = v; break;
+			case 4: r = t; g = p; b = v; break;
+			default: r = v; g = p; b = q; break;
+			}
+		}
+		return Color(
+			static_cast<uint8_t>(r),
+			static_cast<uint8_t>(g),
+			static_cast<uint8_t>(b)
 		);
 	}
 };
\ No newline at end of file
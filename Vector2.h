@@ -0,0 +1,30 @@
+#pragma once
+
+//   .    SFML,      
+struct Vector2i
+{
+	int x = 0;
+	int y = 0;
+
+	constexpr Vector2i() {}
+
+	constexpr Vector2i(int xValue, int yValue) : x(xValue), y(yValue) {}
+
+	Vector2i operator+(const Vector2i& other) const {
+		return Vector2i(x + other.x, y + other.y);
+	}
+
+	Vector2i& operator+=(const Vector2i& other) {
+		x += other.x;
+		y += other.y;
+		return *this;
+	}
+
+	bool operator==(const Vector2i& other) const {
+		return x == other.x && y == other.y;
+	}
+
+	bool operator!=(const Vector2i& other) const {
+		return !(*this == other);
+	}
+};
@@ -1,50 +1,60 @@
-#include <random>
-#include <chrono>
 #include <algorithm>
+#include <string.h>
 #include "Config.h"
 #include "Utils.h"
 #include "Tile.h"
 #include "Gene.h"
-#include "Main.h"
+#include "ThreadPool.h"
+#include "TileStorage.h"
 #include "World.h"
 
-using namespace sf;
-
-const char* DISPLAY_MODES_STRINGS[] = {
-	"Energy", "Life forms", "Species"
-};
-
-World::World(uint16_t width, uint16_t height)
+//     .      ,
+//      ,   ,      2
+static int getBlocksCount(int size, int blockSize)
 {
-	cameraCenter = Vector2f(width * 0.5f, height * 0.5f);
-	displayMode = DISPLAY_MODE_LIFE_FORMS;
-	_width = width;
-	_height = height;
-	_tilemap = new Tile[static_cast<size_t>(width * height)];
-	_directionDistribution = std::uniform_int_distribution<int>(0, DIRECTIONS_COUNT - 1);
-	_tileVertices = new Vertex[static_cast<size_t>(width * height * 6)];
+	int count = (size / blockSize) & ~1;
+	if (count < 2)
+		count = size >= 4 ? 2 : 1;
+	return count;
+}
 
-	size_t gridVerticesCount = static_cast<size_t>(width * height * 4);
-	_gridVertices = new Vertex[gridVerticesCount];
-	for (size_t i = 0; i < gridVerticesCount; i++)
-		_gridVertices[i].color = GRID_COLOR;
+//      
+static int getBlockStart(int block, int blocksCount, int size)
+{
+	return static_cast<int>(static_cast<int64_t>(block) * size / blocksCount);
 }
 
-World::~World()
+World::World(uint16_t width, uint16_t height) :
+	World(width, height, std::make_unique<TileStorage>(static_cast<size_t>(width) * height))
 {
-	delete[] _tilemap;
-	delete[] _tileVertices;
-	delete[] _gridVertices;
 }
 
-void World::selectTile(Vector2f screenPos, Vector2f screenSize)
+World::World(uint16_t width, uint16_t height, std::unique_ptr<TileStorage> tiles)
 {
-	float tileSize = std::max(1.0f, getTileSize());
+	_width = width;
+	_height = height;
+	_tiles = std::move(tiles);
+	_aliveMaskSize = (_tiles->getCount() + 63) / 64;
+	_aliveMask = std::make_unique<std::atomic<uint64_t>[]>(_aliveMaskSize);
+	_tileChangeStamps = std::make_unique<std::atomic<uint32_t>[]>(_aliveMaskSize);
+	for (size_t i = 0; i < _aliveMaskSize; i++) {
+		_aliveMask[i].store(0, std::memory_order_relaxed);
+		_tileChangeStamps[i].store(0, std::memory_order_relaxed);
+	}
 
-	Vector2f tilePos = cameraCenter - (screenSize * 0.5f - screenPos) / tileSize;
+	for (uint8_t i = 0; i < DIRECTIONS_COUNT; i++)
+		_directionOffsets[i] = static_cast<ptrdiff_t>(DIRECTION_VECTORS[i].y) * width + DIRECTION_VECTORS[i].x;
+
+	_blocksCountX = getBlocksCount(width, WORLD_BLOCK_WIDTH);
+	_blocksCountY = getBlocksCount(height, WORLD_BLOCK_HEIGHT);
+	_blocks.resize(static_cast<size_t>(_blocksCountX) * _blocksCountY);
+	_threadPool = std::make_unique<ThreadPool>(1);
+	_genes = std::make_unique<Gene[]>(MAX_GENES_COUNT);
+	_geneChangeStamps = std::make_unique<uint32_t[]>(MAX_GENES_COUNT);
+}
 
-	selectedTilePos.x = static_cast<int>(tilePos.x);
-	selectedTilePos.y = static_cast<int>(tilePos.y);
+World::~World()
+{
 }
 
 void World::removeTileSelection()
@@ -53,32 +63,55 @@ void World::removeTileSelection()
 	selectedTilePos.y = -1;
 }
 
+void World::seed(uint32_t value)
+{
+	_seed = value;
+}
+
 void World::regenerate()
 {
 	_stepCounter = 0;
+	_processedStamp = 0;
+	_tiles->clearProcessedStamps();
+
+	uint32_t aliveTilesCount = 0;
+	for (int y = 0; y < _height; y++) {
+		for (int x = 0; x < _width; x++) {
+			size_t index = getTileIndex(x, y);
+			Random random(_seed, 0, static_cast<uint32_t>(index), Random::STREAM_REGENERATE);
 
-	for (uint16_t x = 0; x < _width; x++) {
-		for (uint16_t y = 0; y < _height; y++) {
-			Tile& tile = getTileAt(x, y);
-			tile.temp = Main::randomFloat() * 2.0f - 1.0f;
-			tile.direction = _directionDistribution(Main::getRandomGenerator());
-			tile.energy = 0.0f;
-			tile.geneIndex = 0;
-			tile.eatenFoodCount = 0;
-			tile.photosynthCount = 0;
-			tile.commandsCounter = 0;
-
-			if (Main::randomFloat() < populationDensity) {
+			Tile tile;
+			tile.temp = random.nextFloat() * 2.0f - 1.0f;
+			tile.direction = static_cast<uint8_t>(random.nextInt(DIRECTIONS_COUNT));
+
+			if (random.nextFloat() < populationDensity) {
 				tile.energy = spawnEnergy;
 				tile.geneIndex = 1;
 			}
+
+			_tiles->set(index, tile);
+			setTileAlive(index, tile.geneIndex != 0);
+			markTileChanged(index);
+			if (tile.geneIndex != 0)
+				aliveTilesCount++;
 		}
 	}
 
-	_genes.clear();
+	for (uint16_t i = 0; i < _genesCount; i++) {
+		_genes[i].release();
+		markGeneChanged(i + 1);
+	}
+	_genesCount = 0;
+	_usedGenesCount = 0;
+	_freeGeneSlots.clear();
 
-	//     
+	//     .        
+	if (aliveTilesCount == 0)
+		return;
+	Random random(_seed, 0, 0, Random::STREAM_GENES);
 	Gene* gene = addGene(0);
+	gene->referenceCount = aliveTilesCount;
+	gene->color = Utils::hsvToRgb(random.nextFloat() * 255.0f, 1.0f, 255.0f);
 	for (uint8_t i = 0; i < GENE_COMMANDS_COUNT; i++) {
 		gene->setCommand(i, COMMAND_PHOTOSYNTH);
 	}
@@ -86,124 +119,90 @@ void World::regenerate()
 
 void World::update()
 {
+	ProfilerScope stepScope(_profiler, PROFILER_STEP);
+	ProfilerScope prepareScope(_profiler, PROFILER_STEP_PREPARE);
 	_maxEnergy = 0.0f;
 	_aliveTilesCounter = 0;
-
-	//     
-	for (uint16_t i = 0; i < _genes.size(); i++) {
-		if (_genes[i])
-			_genes[i].get()->referenceCount = 0;
+	_mutationsCounter = 0;
+
+	//   ,        ,
+	//       .   
+	//       ,   
+	if (++_processedStamp == 0) {
+		_tiles->clearProcessedStamps();
+		_processedStamp = 1;
 	}
 
-	//    
-	for (uint16_t x = 0; x < _width; x++) {
-		for (uint16_t y = 0; y < _height; y++) {
-			getTileAt(x, y).wasProcessed = false;
+	_followedTilePos = followSelectedTile ? selectedTilePos : Vector2i(-1, -1);
+	prepareScope.stop();
+
+	//     .       ,
+	//             
+	for (int phase = 0; phase < 4; phase++) {
+		int phaseX = phase % 2;
+		int phaseY = phase / 2;
+		int countX = (_blocksCountX - phaseX + 1) / 2;
+		int countY = (_blocksCountY - phaseY + 1) / 2;
+
+		ProfilerScope tilesScope(_profiler, PROFILER_STEP_TILES);
+		_threadPool->run(static_cast<size_t>(countX) * countY, [&](size_t task) {
+			processBlock(phaseX + 2 * static_cast<int>(task % countX), phaseY + 2 * static_cast<int>(task / countX));
+		});
+		tilesScope.stop();
+
+		//   ,          
+		ProfilerScope genesScope(_profiler, PROFILER_STEP_GENES);
+		for (int blockY = phaseY; blockY < _blocksCountY; blockY += 2) {
+			for (int blockX = phaseX; blockX < _blocksCountX; blockX += 2) {
+				applyMutations(_blocks[static_cast<size_t>(blockY) * _blocksCountX + blockX]);
+			}
 		}
-	}
 
-	//   
-	for (uint16_t x = 0; x < _width; x++) {
-		for (uint16_t y = 0; y < _height; y++) {
-			processTile(x, y);
-		}
+		releaseUnusedGenes(phaseX, phaseY);
 	}
 
-	//  ,     
-	for (uint16_t i = 0; i < _genes.size(); i++) {
-		if (_genes[i] && _genes[i].get()->referenceCount == 0)
-			_genes[i].reset();
+	//   .     ,   
+	//     
+	ProfilerScope statsScope(_profiler, PROFILER_STEP_PREPARE);
+	StepStats stats = {};
+	double totalEnergy = 0.0;
+	for (auto& block : _blocks) {
+		_aliveTilesCounter += block.aliveTilesCounter;
+		if (block.maxEnergy > _maxEnergy)
+			_maxEnergy = block.maxEnergy;
+		stats.aliveTilesCount += block.livingCounter;
+		stats.predatorsCount += block.predatorsCounter;
+		totalEnergy += block.totalEnergy;
+		stats.birthsCount += block.birthsCounter;
+		stats.deathsCount += block.deathsCounter;
+		stats.movesCount += block.movesCounter;
 	}
 
 	_stepCounter++;
+	stats.step = _stepCounter;
+	//       ,    
+	stats.plantsCount = countLifeForms ? stats.aliveTilesCount - stats.predatorsCount : 0;
+	stats.totalEnergy = static_cast<float>(totalEnergy);
+	stats.maxEnergy = _maxEnergy;
+	stats.genesCount = _usedGenesCount;
+	stats.mutationsCount = _mutationsCounter;
+	_statsHistory.add(stats);
+	statsScope.stop();
+
+	stepScope.stop();
+	_profiler.commit();
 }
 
-void World::render(RenderTarget& renderTarget)
-{
-	float tileSize = std::max(1.0f, getTileSize());
-
-	auto cameraPos = cameraCenter * tileSize;
-	auto halfSize = Vector2f(renderTarget.getSize()) * 0.5f;
-	auto leftTop = cameraPos - halfSize;
-	auto offset = Vector2f(leftTop.x - floorf(leftTop.x), leftTop.y - floorf(leftTop.y));
-	auto leftTopTile = Vector2i(static_cast<int>(leftTop.x / tileSize), static_cast<int>(leftTop.y / tileSize));
-
-	//   
-	int countX = static_cast<int>((renderTarget.getSize().x - 1) / tileSize) + 2;
-	int countY = static_cast<int>((renderTarget.getSize().y - 1) / tileSize) + 2;
-
-	//  ,     
-	int startX = std::max(0, leftTopTile.x);
-	int endX = std::min(leftTopTile.x + countX, _width);
-	int startY = std::max(0, leftTopTile.y);
-	int endY = std::min(leftTopTile.y + countY, _height);
-
-	uint32_t tilesVerticesSize = (endX - startX) * (endY - startY) * 6;
-	uint32_t gridVerticesSize = (endX - startX) * (endY - startY) * 4;
-
-	uint32_t tilesVerticesCounter = 0;
-	uint32_t gridVerticesCounter = 0;
-	for (int x = startX; x < endX; x++) {
-		for (int y = startY; y < endY; y++) {
-			Tile& tile = getTileAt(x, y);
-			Color tileColor = getTileColor(x, y);
-			auto tilePos = Vector2f((float)x, (float)y) * tileSize - offset - cameraPos + halfSize;
-
-			_tileVertices[tilesVerticesCounter].color = tileColor;
-			_tileVertices[tilesVerticesCounter].position = tilePos;
-			_gridVertices[gridVerticesCounter++].position = tilePos;
-			tilesVerticesCounter++;
-			
-			_tileVertices[tilesVerticesCounter].color = tileColor;
-			_tileVertices[tilesVerticesCounter].position = tilePos + Vector2f(tileSize, 0.0f);
-			_gridVertices[gridVerticesCounter++].position = _tileVertices[tilesVerticesCounter].position;
-			_gridVertices[gridVerticesCounter++].position = _tileVertices[tilesVerticesCounter].position;
-			tilesVerticesCounter++;
-
-			_tileVertices[tilesVerticesCounter].color = tileColor;
-			_tileVertices[tilesVerticesCounter].position = tilePos + Vector2f(tileSize, tileSize);
-			_gridVertices[gridVerticesCounter++].position = _tileVertices[tilesVerticesCounter].position;
-			tilesVerticesCounter++;
-
-			_tileVertices[tilesVerticesCounter].color = tileColor;
-			_tileVertices[tilesVerticesCounter].position = tilePos + Vector2f(tileSize, tileSize);
-			tilesVerticesCounter++;
-
-			_tileVertices[tilesVerticesCounter].color = tileColor;
-			_tileVertices[tilesVerticesCounter].position = tilePos + Vector2f(0.0f, tileSize);
-			tilesVerticesCounter++;
-
-			_tileVertices[tilesVerticesCounter].color = tileColor;
-			_tileVertices[tilesVerticesCounter].position = tilePos;
-			tilesVerticesCounter++;
-		}
-	}
-
-	//   
-	renderTarget.draw(_tileVertices, tilesVerticesSize, PrimitiveType::Triangles);
-
-	//  
-	if (isGridEnabled)
-		renderTarget.draw(_gridVertices, gridVerticesSize, PrimitiveType::Lines);
+void World::setThreadsCount(unsigned count)
+{
+	if (count == 0)
+		count = std::max(1u, std::thread::hardware_concurrency());
+	_threadPool = std::make_unique<ThreadPool>(count);
+}
 
-	static Vertex selectedTileVertices[] = {
-		Vertex(Vector2f(), SELECTION_COLOR),
-		Vertex(Vector2f(), SELECTION_COLOR),
-		Vertex(Vector2f(), SELECTION_COLOR),
-		Vertex(Vector2f(), SELECTION_COLOR),
-		Vertex(Vector2f(), SELECTION_COLOR)
-	};
-	if (getSelectedTile() != nullptr) {
-		Vector2f tilePos = Vector2f(selectedTilePos) * tileSize - offset - cameraPos + halfSize;
-		selectedTileVertices[0].position = tilePos;
-		selectedTileVertices[1].position = tilePos + Vector2f(tileSize, 0.0f);
-		selectedTileVertices[2].position = tilePos + Vector2f(tileSize, tileSize);
-		selectedTileVertices[3].position = tilePos + Vector2f(0.0f, tileSize);
-		selectedTileVertices[4].position = tilePos;
-
-		//    
-		renderTarget.draw(selectedTileVertices, 5, PrimitiveType::LinesStrip);
-	}
+unsigned World::getThreadsCount()
+{
+	return _threadPool->getThreadsCount();
 }
 
 int World::getWidth()
@@ -216,24 +215,32 @@ int World::getHeight()
 	return _height;
 }
 
-Tile* World::getSelectedTile()
+bool World::hasSelectedTile()
 {
-	if (selectedTilePos.x >= 0 && selectedTilePos.y >= 0 &&
-		selectedTilePos.x < _width && selectedTilePos.y < _height)
-		return &getTileAt(selectedTilePos.x, selectedTilePos.y);
-	return nullptr;
+	return selectedTilePos.x >= 0 && selectedTilePos.y >= 0 &&
+		selectedTilePos.x < _width && selectedTilePos.y < _height;
 }
 
-Tile& World::getTileAt(int x, int y)
+Tile World::getTileAt(int x, int y)
 {
-	x = Utils::mod(x, (int)_width);
-	y = Utils::mod(y, (int)_height);
-	return _tilemap[getTileIndex(x, y)];
+	return _tiles->get(getWrappedTileIndex(x, y));
 }
 
-float World::getTileSize()
+void World::setTileAt(int x, int y, const Tile& tile)
 {
-	return TILE_SIZE * cameraZoom;
+	size_t index = getWrappedTileIndex(x, y);
+
+	//        
+	Gene* newGene = getGene(tile.geneIndex);
+	if (newGene != nullptr)
+		newGene->referenceCount++;
+	Gene* oldGene = getGene(_tiles->geneIndex[index]);
+	if (oldGene != nullptr && --oldGene->referenceCount == 0)
+		releaseGene(oldGene->getIndex());
+
+	_tiles->set(index, tile);
+	setTileAlive(index, tile.geneIndex != 0);
+	markTileChanged(index);
 }
 
 int World::getStepsCount()
@@ -243,26 +250,59 @@ int World::getStepsCount()
 
 uint16_t World::getGenesCount()
 {
-	return static_cast<uint16_t>(_genes.size());
+	return _genesCount;
+}
+
+uint16_t World::getUsedGenesCount()
+{
+	return _usedGenesCount;
 }
 
 Gene* World::addGene(uint16_t parentGeneIndex)
 {
-	for (uint16_t i = 0; i < _genes.size(); i++) {
-		if (!_genes[i]) {
-			_genes[i] = std::make_unique<Gene>(i + 1, parentGeneIndex);
-			return _genes[i].get();
-		}
+	if (!_freeGeneSlots.empty()) {
+		uint16_t slot = _freeGeneSlots.back();
+		_freeGeneSlots.pop_back();
+		_genes[slot].init(slot + 1, parentGeneIndex);
+		markGeneChanged(slot + 1);
+		_usedGenesCount++;
+		return &_genes[slot];
 	}
-	_genes.push_back(std::make_unique<Gene>(static_cast<uint16_t>(_genes.size() + 1), parentGeneIndex));
-	return _genes[_genes.size() - 1].get();
+	//    
+	if (_genesCount >= MAX_GENES_COUNT)
+		return nullptr;
+	Gene* gene = &_genes[_genesCount++];
+	gene->init(_genesCount, parentGeneIndex);
+	markGeneChanged(_genesCount);
+	_usedGenesCount++;
+	return gene;
+}
+
+void World::setGeneCommand(uint16_t geneIndex, uint8_t num, uint8_t command)
+{
+	Gene* gene = getGene(geneIndex);
+	if (gene == nullptr)
+		return;
+	gene->setCommand(num, command);
+	markGeneChanged(geneIndex);
+}
+
+void World::setGeneColor(uint16_t geneIndex, Color color)
+{
+	Gene* gene = getGene(geneIndex);
+	if (gene == nullptr)
+		return;
+	gene->color = color;
+	markGeneChanged(geneIndex);
+	_geneColorsEpoch = _changeEpoch;
 }
 
 Gene* World::getGene(uint16_t index)
 {
-	if (index == 0 || index > _genes.size())
+	if (index == 0 || index > _genesCount)
 		return nullptr;
-	return _genes[index - 1].get();
+	Gene* gene = &_genes[index - 1];
+	return gene->isUsed() ? gene : nullptr;
 }
 
 float World::getEnergyMaximum()
@@ -275,51 +315,263 @@ uint32_t World::getAliveTilesCount()
 	return _aliveTilesCounter;
 }
 
+uint32_t World::getSeed()
+{
+	return _seed;
+}
+
+Profiler& World::getProfiler()
+{
+	return _profiler;
+}
+
+StatsHistory& World::getStatsHistory()
+{
+	return _statsHistory;
+}
+
+uint64_t World::getChecksum()
+{
+	// FNV-1a       
+	uint64_t hash = 14695981039346656037ull;
+	auto append = [&hash](const void* data, size_t size) {
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; i++) {
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+	};
+
+	size_t count = _tiles->getCount();
+	append(_tiles->temp, count * sizeof(float));
+	append(_tiles->energy, count * sizeof(float));
+	append(_tiles->eatenFoodCount, count * sizeof(uint32_t));
+	append(_tiles->photosynthCount, count * sizeof(uint32_t));
+	append(_tiles->geneIndex, count * sizeof(uint16_t));
+	append(_tiles->direction, count * sizeof(uint8_t));
+	append(_tiles->commandsCounter, count * sizeof(uint8_t));
+
+	for (uint32_t n = 1; n <= getGenesCount(); n++) {
+		uint16_t i = static_cast<uint16_t>(n);
+		Gene* gene = getGene(i);
+		if (gene == nullptr)
+			continue;
+		uint16_t parentIndex = gene->getParentIndex();
+		append(&i, sizeof(i));
+		append(&parentIndex, sizeof(parentIndex));
+		for (uint8_t k = 0; k < GENE_COMMANDS_COUNT; k++) {
+			uint8_t command = gene->getCommand(k);
+			append(&command, sizeof(command));
+		}
+	}
+
+	return hash;
+}
+
 size_t World::getTileIndex(int x, int y)
 {
 	return (size_t)y * _width + x;
 }
 
-void World::processTile(int x, int y)
+size_t World::getWrappedTileIndex(int x, int y)
+{
+	return getTileIndex(Utils::mod(x, _width), Utils::mod(y, _height));
+}
+
+void World::applyMutations(BlockContext& context)
+{
+	for (auto& mutation : context.mutations) {
+		uint16_t& geneIndex = _tiles->geneIndex[mutation.tileIndex];
+
+		//     
+		if (geneIndex != mutation.geneIndex)
+			continue;
+
+		Gene* gene = getGene(mutation.geneIndex);
+		geneIndex = gene->mutate(*this, mutation.random);
+		getGene(geneIndex)->referenceCount++;
+		removeGeneReference(mutation.geneIndex, context);
+		_mutationsCounter++;
+	}
+	context.mutations.clear();
+}
+
+void World::removeGeneReference(uint16_t geneIndex, BlockContext& context)
+{
+	//      ,     
+	//      
+	if (--getGene(geneIndex)->referenceCount == 0)
+		context.releasedGenes.push_back(geneIndex);
+}
+
+void World::releaseUnusedGenes(int phaseX, int phaseY)
+{
+	_releasedGenes.clear();
+	for (int blockY = phaseY; blockY < _blocksCountY; blockY += 2) {
+		for (int blockX = phaseX; blockX < _blocksCountX; blockX += 2) {
+			auto& releasedGenes = _blocks[static_cast<size_t>(blockY) * _blocksCountX + blockX].releasedGenes;
+			_releasedGenes.insert(_releasedGenes.end(), releasedGenes.begin(), releasedGenes.end());
+			releasedGenes.clear();
+		}
+	}
+
+	//     ,    ,
+	//      
+	std::sort(_releasedGenes.begin(), _releasedGenes.end());
+	for (uint16_t geneIndex : _releasedGenes)
+		releaseGene(geneIndex);
+}
+
+void World::releaseGene(uint16_t geneIndex)
+{
+	_genes[geneIndex - 1].release();
+	markGeneChanged(geneIndex);
+	_freeGeneSlots.push_back(geneIndex - 1);
+	_usedGenesCount--;
+}
+
+void World::processBlock(int blockX, int blockY)
+{
+	BlockContext& context = _blocks[static_cast<size_t>(blockY) * _blocksCountX + blockX];
+	context.aliveTilesCounter = 0;
+	context.maxEnergy = 0.0f;
+	context.livingCounter = 0;
+	context.predatorsCounter = 0;
+	context.totalEnergy = 0.0f;
+	context.birthsCounter = 0;
+	context.deathsCounter = 0;
+	context.movesCounter = 0;
+	context.mutations.clear();
+	context.releasedGenes.clear();
+
+	int startX = getBlockStart(blockX, _blocksCountX, _width);
+	int endX = getBlockStart(blockX + 1, _blocksCountX, _width);
+	int startY = getBlockStart(blockY, _blocksCountY, _height);
+	int endY = getBlockStart(blockY + 1, _blocksCountY, _height);
+
+	for (int y = startY; y < endY; y++) {
+		//        
+		bool isBorderRow = y == 0 || y == _height - 1;
+		size_t rowIndex = getTileIndex(0, y);
+
+		forEachAliveTile(rowIndex + startX, rowIndex + endX, [&](size_t index) {
+			int x = static_cast<int>(index - rowIndex);
+			if (isBorderRow || x == 0 || x == _width - 1)
+				processTile<true>(x, y, context);
+			else
+				processTile<false>(x, y, context);
+		});
+	}
+}
+
+void World::markTileChanged(size_t index)
+{
+	//    ,     ,    
+	std::atomic<uint32_t>& stamp = _tileChangeStamps[index >> 6];
+	if (stamp.load(std::memory_order_relaxed) != _changeEpoch)
+		stamp.store(_changeEpoch, std::memory_order_relaxed);
+}
+
+void World::markGeneChanged(uint16_t geneIndex)
+{
+	_geneChangeStamps[geneIndex - 1] = _changeEpoch;
+}
+
+uint32_t World::beginChangeEpoch()
 {
+	return _changeEpoch++;
+}
+
+void World::setTileAlive(size_t index, bool isAlive)
+{
+	uint64_t bit = 1ull << (index & 63);
+	if (isAlive)
+		_aliveMask[index >> 6].fetch_or(bit, std::memory_order_relaxed);
+	else
+		_aliveMask[index >> 6].fetch_and(~bit, std::memory_order_relaxed);
+}
+
+template<typename Function>
+void World::forEachAliveTile(size_t begin, size_t end, Function function)
+{
+	//     . ,    ,   
+	for (size_t word = begin >> 6; word < ((end + 63) >> 6); word++) {
+		uint64_t bits = _aliveMask[word].load(std::memory_order_relaxed);
+
+		size_t wordBegin = word << 6;
+		if (begin > wordBegin)
+			bits &= ~0ull << (begin - wordBegin);
+		if (end < wordBegin + 64)
+			bits &= ~(~0ull << (end - wordBegin));
+
+		while (bits != 0) {
+			function(wordBegin + Utils::countTrailingZeros(bits));
+			bits &= bits - 1;
+		}
+	}
+}
+
+template<bool IsBorder>
+size_t World::getNeighbourIndex(size_t index, int x, int y, uint8_t direction)
+{
+	if (IsBorder)
+		return getWrappedTileIndex(x + DIRECTION_VECTORS[direction].x, y + DIRECTION_VECTORS[direction].y);
+	return index + _directionOffsets[direction];
+}
+
+template<bool IsBorder>
+void World::processTile(int x, int y, BlockContext& context)
+{
+	TileStorage& tiles = *_tiles;
+
 	//   
-	Tile& tile = getTileAt(x, y);
+	size_t index = getTileIndex(x, y);
 
 	//   ,  
-	if (tile.wasProcessed)
+	if (tiles.processedStamp[index] == _processedStamp)
 		return;
-	tile.wasProcessed = true;
+	tiles.processedStamp[index] = _processedStamp;
 
 	//   - 
-	if (tile.geneIndex == 0)
+	uint16_t& geneIndex = tiles.geneIndex[index];
+	if (geneIndex == 0)
 		return;
 
-	_aliveTilesCounter++;
+	context.aliveTilesCounter++;
+	//      
+	markTileChanged(index);
+
+	float& energy = tiles.energy[index];
+	uint8_t& direction = tiles.direction[index];
+	uint8_t& commandsCounter = tiles.commandsCounter[index];
 
 	//   
-	Gene* gene = getGene(tile.geneIndex);
-	//      
-	gene->referenceCount++;
+	Gene* gene = getGene(geneIndex);
 
 	//    
-	auto tileDirection = DIRECTION_VECTORS[tile.direction];
+	auto tileDirection = DIRECTION_VECTORS[direction];
 
 	//    
-	Tile& frontTile = getTileAt(x + tileDirection.x, y + tileDirection.y);
+	size_t frontIndex = getNeighbourIndex<IsBorder>(index, x, y, direction);
+	// ,      
+	size_t aliveIndex = index;
 
 	//     
-	tile.energy -= energySpending;
+	energy -= energySpending;
 
 	//       
-	if (tile.energy > reproductionEnergy) {
+	if (energy > reproductionEnergy) {
+		//       ,    
+		Random random(_seed, _stepCounter, static_cast<uint32_t>(index), Random::STREAM_STEP);
+
 		//   
-		bool freeTiles[DIRECTIONS_COUNT];
+		bool freeTiles[DIRECTIONS_COUNT] = {};
 		uint8_t freeTilesCount = 0;
 
 		//    
 		for (uint8_t i = 0; i < DIRECTIONS_COUNT; i++) {
-			Tile& currTile = getTileAt(x + DIRECTION_VECTORS[i].x, y + DIRECTION_VECTORS[i].y);
-			if (currTile.geneIndex != tile.geneIndex) {
+			size_t currIndex = getNeighbourIndex<IsBorder>(index, x, y, i);
+			if (tiles.geneIndex[currIndex] != geneIndex) {
 				freeTiles[i] = true;
 				freeTilesCount++;
 			}
@@ -327,9 +579,8 @@ void World::processTile(int x, int y)
 
 		//   
 		if (freeTilesCount > 0) {
-			std::uniform_int_distribution<int> distr(0, freeTilesCount - 1);
 			//   
-			uint8_t spawnDirection = static_cast<uint8_t>(distr(Main::getRandomGenerator()));
+			uint8_t spawnDirection = static_cast<uint8_t>(random.nextInt(freeTilesCount));
 
 			//  
 			uint8_t counter = 0;
@@ -343,121 +594,152 @@ void World::processTile(int x, int y)
 			}
 
 			//   
-			Tile& currTile = getTileAt(x + DIRECTION_VECTORS[spawnDirection].x, y + DIRECTION_VECTORS[spawnDirection].y);
-			currTile.eatenFoodCount = 0;
-			currTile.photosynthCount = 0;
-			currTile.geneIndex = tile.geneIndex;
-			currTile.energy += tile.energy / 2.0f;
-			currTile.direction = _directionDistribution(Main::getRandomGenerator());
-			currTile.wasProcessed = true;
-			tile.energy /= 2.0f;
+			size_t currIndex = getNeighbourIndex<IsBorder>(index, x, y, spawnDirection);
+			//         
+			if (tiles.geneIndex[currIndex] != 0) {
+				removeTileStats(currIndex, context);
+				removeGeneReference(tiles.geneIndex[currIndex], context);
+				context.deathsCounter++;
+			}
+			context.birthsCounter++;
+			tiles.eatenFoodCount[currIndex] = 0;
+			tiles.photosynthCount[currIndex] = 0;
+			tiles.geneIndex[currIndex] = geneIndex;
+			tiles.energy[currIndex] += energy / 2.0f;
+			tiles.direction[currIndex] = static_cast<uint8_t>(random.nextInt(DIRECTIONS_COUNT));
+			tiles.processedStamp[currIndex] = _processedStamp;
+			setTileAlive(currIndex, true);
+			markTileChanged(currIndex);
+			energy /= 2.0f;
+			addTileStats(currIndex, context);
 
 			//     
-			if (Main::randomFloat() < mutationChance)
-				currTile.geneIndex = gene->mutate(*this);
+			if (random.nextFloat() < mutationChance)
+				context.mutations.push_back({ currIndex, geneIndex, random });
 
-			getGene(currTile.geneIndex)->referenceCount++;
+			gene->referenceCount++;
 		} else {
 			//  ,    
-			tile.geneIndex = 0;
+			removeGeneReference(geneIndex, context);
+			geneIndex = 0;
+			context.deathsCounter++;
 		}
 	}
 
-	//   
-	if (tile.energy > _maxEnergy)
-		_maxEnergy = tile.energy;
-
 	//   
-	tile.commandsCounter %= GENE_COMMANDS_COUNT;
-	uint8_t opcode = gene->getCommand(tile.commandsCounter);
+	commandsCounter %= GENE_COMMANDS_COUNT;
+	uint8_t opcode = gene->getCommand(commandsCounter);
+	uint16_t frontGeneIndex = tiles.geneIndex[frontIndex];
 	switch (opcode)
 	{
 	case COMMAND_LOOK:
 		//  - 
-		if (frontTile.geneIndex == 0) {
+		if (frontGeneIndex == 0) {
 			//  - 
-			if (frontTile.energy > 0.0f)
-				tile.commandsCounter += 1;
+			if (tiles.energy[frontIndex] > 0.0f)
+				commandsCounter += 1;
 			else	//  
-				tile.commandsCounter += 3;
+				commandsCounter += 3;
 		}
 		//   - 
-		else if (getGene(frontTile.geneIndex)->getParentIndex() == gene->getParentIndex()) {
-			tile.commandsCounter += 2;
+		else if (getGene(frontGeneIndex)->getParentIndex() == gene->getParentIndex()) {
+			commandsCounter += 2;
 		} else {
-			tile.commandsCounter += 1;
+			commandsCounter += 1;
 		}
 
 		break;
 	case COMMAND_MOVE:
 		//   - 
-		if (frontTile.geneIndex > 0 && getGene(frontTile.geneIndex)->getParentIndex() == gene->getParentIndex()) {
-			tile.commandsCounter += 2;
+		if (frontGeneIndex > 0 && getGene(frontGeneIndex)->getParentIndex() == gene->getParentIndex()) {
+			commandsCounter += 2;
 		} else {
-			tile.commandsCounter += 1;
-			tile.energy += frontTile.energy;
-			tile.energy -= moveEnergy;
-			if (frontTile.energy > 0.0f)
-				tile.eatenFoodCount++;
-			frontTile = tile;
-
-			if (followSelectedTile && x == selectedTilePos.x && y == selectedTilePos.y) {
+			commandsCounter += 1;
+			energy += tiles.energy[frontIndex];
+			energy -= moveEnergy;
+			if (tiles.energy[frontIndex] > 0.0f)
+				tiles.eatenFoodCount[index]++;
+			//    ,        
+			if (frontGeneIndex != 0) {
+				removeTileStats(frontIndex, context);
+				removeGeneReference(frontGeneIndex, context);
+				context.deathsCounter++;
+			}
+			context.movesCounter++;
+			tiles.copy(index, frontIndex);
+			aliveIndex = frontIndex;
+			setTileAlive(frontIndex, geneIndex != 0);
+			markTileChanged(frontIndex);
+
+			if (x == _followedTilePos.x && y == _followedTilePos.y) {
 				selectedTilePos += tileDirection;
 			}
 
-			tile.energy = 0.0f;
-			tile.geneIndex = 0;
-			tile.commandsCounter = 0;
+			energy = 0.0f;
+			geneIndex = 0;
+			commandsCounter = 0;
 		}
 		break;
 	case COMMAND_TURN_CW:
-		tile.direction = Utils::mod(tile.direction - 1, DIRECTIONS_COUNT);
-		tile.commandsCounter++;
+		direction = Utils::mod(direction - 1, DIRECTIONS_COUNT);
+		commandsCounter++;
 		break;
 	case COMMAND_TURN_CCW:
-		tile.direction = (tile.direction + 1) % DIRECTIONS_COUNT;
-		tile.commandsCounter++;
+		direction = (direction + 1) % DIRECTIONS_COUNT;
+		commandsCounter++;
 		break;
 	case COMMAND_PHOTOSYNTH:
-		tile.photosynthCount++;
-		tile.energy += photosynthEnergy;
-		tile.commandsCounter++;
+		tiles.photosynthCount[index]++;
+		energy += photosynthEnergy;
+		commandsCounter++;
 		break;
 	default:
-		tile.commandsCounter += opcode;
+		commandsCounter += opcode;
 		break;
 	}
 
 	//  ,      
-	if (tile.energy <= 0.0f) {
-		tile.energy = 0.0f;
-		tile.commandsCounter = 0;
-		tile.eatenFoodCount = 0;
-		tile.photosynthCount = 0;
-		tile.geneIndex = 0;
+	if (energy <= 0.0f) {
+		if (geneIndex != 0) {
+			removeGeneReference(geneIndex, context);
+			context.deathsCounter++;
+		}
+		energy = 0.0f;
+		commandsCounter = 0;
+		tiles.eatenFoodCount[index] = 0;
+		tiles.photosynthCount[index] = 0;
+		geneIndex = 0;
 	}
+
+	//    
+	if (geneIndex == 0)
+		setTileAlive(index, false);
+
+	//     ,      
+	if (tiles.geneIndex[aliveIndex] != 0)
+		addTileStats(aliveIndex, context);
 }
 
-sf::Color World::getTileColor(int x, int y) {
-	Tile& tile = getTileAt(x, y);
+void World::addTileStats(size_t index, BlockContext& context)
+{
+	TileStorage& tiles = *_tiles;
+	float energy = tiles.energy[index];
+	if (energy > context.maxEnergy)
+		context.maxEnergy = energy;
+	context.livingCounter++;
+	context.totalEnergy += energy;
+	if (countLifeForms)
+		context.predatorsCounter += tiles.eatenFoodCount[index] > tiles.photosynthCount[index];
+}
 
-	switch (displayMode) {
-	case DISPLAY_MODE_ENERGY:
-		return Utils::mixColors(sf::Color::Blue, sf::Color::Red, tile.energy / _maxEnergy);
-	case DISPLAY_MODE_LIFE_FORMS:
-		if (tile.geneIndex != 0) {
-			if (tile.eatenFoodCount > tile.photosynthCount)
-				return PREDATOR_COLOR;
-			else
-				return PLANTS_COLOR;
-		}
-		else if (tile.energy > 0.0f)
-			return FOOD_COLOR;
-		else
-			return sf::Color::Black;
-	case DISPLAY_MODE_SPECIES:
-		Gene* gene = getGene(tile.geneIndex);
-		return gene != nullptr ? gene->color : sf::Color::Black;
-	}
-	return sf::Color::Black;
+void World::removeTileStats(size_t index, BlockContext& context)
+{
+	// ,       ,    
+	TileStorage& tiles = *_tiles;
+	if (tiles.processedStamp[index] != _processedStamp)
+		return;
+	context.livingCounter--;
+	context.totalEnergy -= tiles.energy[index];
+	if (countLifeForms)
+		context.predatorsCounter -= tiles.eatenFoodCount[index] > tiles.photosynthCount[index];
 }
\ No newline at end of file
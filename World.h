@@ -1,43 +1,37 @@
 #pragma once
 
 #include <stdint.h>
+#include <atomic>
 #include <memory>
-#include <random>
 #include <vector>
+#include "Color.h"
+#include "Profiler.h"
+#include "Random.h"
+#include "StatsHistory.h"
 #include "Tile.h"
-#include <SFML/Graphics.hpp>
+#include "Vector2.h"
 
 class Tile;
 class Gene;
-
-//   
-enum DisplayMode {
-	DISPLAY_MODE_ENERGY, DISPLAY_MODE_LIFE_FORMS, DISPLAY_MODE_SPECIES, DISPLAY_MODES_COUNT
-};
-
-//     
-const char* DISPLAY_MODES_STRINGS[];
+class ThreadPool;
+class TileStorage;
 
 class World
 {
+	friend class Snapshot;
+	friend class WorldFrame;
+
 public:
 	World(uint16_t width, uint16_t height);
 	~World();
 
-	//    
-	sf::Vector2f cameraCenter;
-	float cameraZoom = 1.0f;
-
-	//   
-	bool isGridEnabled = true;
-
 	// ,  .  {-1, -1},    .
-	sf::Vector2i selectedTilePos;
+	Vector2i selectedTilePos;
 	//     
 	bool followSelectedTile = false;
-
-	//    
-	DisplayMode displayMode;
+	//        .        
+	//       ,       
+	bool countLifeForms = false;
 
 	//   
 	float photosynthEnergy = 0.05f;
@@ -54,42 +48,158 @@ public:
 	//   ,     
 	float spawnEnergy = 0.05f;
 
-	void selectTile(sf::Vector2f screenPos, sf::Vector2f screenSize);
 	void removeTileSelection();
+	void seed(uint32_t value);
 	void regenerate();
 	void update();
-	void render(sf::RenderTarget&);
+	//     . 0 -    
+	void setThreadsCount(unsigned count);
+	unsigned getThreadsCount();
 
 	int getWidth();
 	int getHeight();
-	Tile* getSelectedTile();
-	Tile& getTileAt(int x, int y);
-	float getTileSize();
+	//       
+	bool hasSelectedTile();
+	//   .     
+	Tile getTileAt(int x, int y);
+	//  .     
+	void setTileAt(int x, int y, const Tile& tile);
 	int getStepsCount();
+	//   .       1   
 	uint16_t getGenesCount();
+	//  ,    
+	uint16_t getUsedGenesCount();
 	Gene* addGene(uint16_t parentGeneIndex);
 	Gene* getGene(uint16_t index);
+	//     .       ,
+	//      
+	void setGeneCommand(uint16_t geneIndex, uint8_t num, uint8_t command);
+	void setGeneColor(uint16_t geneIndex, Color color);
+	//       .    .
+	//       ,    
+	uint32_t beginChangeEpoch();
 	float getEnergyMaximum();
 	uint32_t getAliveTilesCount();
+	uint32_t getSeed();
+	//    
+	Profiler& getProfiler();
+	//   
+	StatsHistory& getStatsHistory();
+	//       
+	uint64_t getChecksum();
 
 private:
+	//      ,    
+	World(uint16_t width, uint16_t height, std::unique_ptr<TileStorage> tiles);
+
+	//    .   ,       
+	struct PendingMutation
+	{
+		size_t tileIndex;
+		uint16_t geneIndex;
+		//   ,    
+		Random random;
+	};
+
+	//     
+	struct BlockContext
+	{
+		uint32_t aliveTilesCounter = 0;
+		float maxEnergy = 0.0f;
+		//     , . StepStats.      
+		//     ,       ,    
+		//  ,   .      
+		uint32_t livingCounter = 0;
+		uint32_t predatorsCounter = 0;
+		float totalEnergy = 0.0f;
+		uint32_t birthsCounter = 0;
+		uint32_t deathsCounter = 0;
+		uint32_t movesCounter = 0;
+		std::vector<PendingMutation> mutations;
+		// ,      
+		std::vector<uint16_t> releasedGenes;
+	};
+
 	int _width;
 	int _height;
 	uint32_t _stepCounter = 0;
-	Tile* _tilemap;
+	//      
+	uint32_t _processedStamp = 0;
+	uint32_t _seed = 0;
+	std::unique_ptr<TileStorage> _tiles;
+	//    .     ,
+	//        ,     
+	std::unique_ptr<std::atomic<uint64_t>[]> _aliveMask;
+	size_t _aliveMaskSize;
+	//        64  (   )
+	//     
+	uint32_t _changeEpoch = 1;
+	std::unique_ptr<std::atomic<uint32_t>[]> _tileChangeStamps;
+	std::unique_ptr<uint32_t[]> _geneChangeStamps;
+	//       setGeneColor.     ,
+	//     
+	uint32_t _geneColorsEpoch = 0;
 	float _maxEnergy = 0.0f;
 	uint32_t _aliveTilesCounter = 0;
-	std::vector<std::unique_ptr<Gene>> _genes;
-	std::uniform_int_distribution<int> _directionDistribution;
-	sf::Vertex* _tileVertices;
-	sf::Vertex* _gridVertices;
+	Profiler _profiler;
+	StatsHistory _statsHistory;
+	// ,    
+	uint32_t _mutationsCounter = 0;
+	//      .    i    i - 1
+	std::unique_ptr<Gene[]> _genes;
+	//   ,   
+	uint16_t _genesCount = 0;
+	uint16_t _usedGenesCount = 0;
+	//     _genes
+	std::vector<uint16_t> _freeGeneSlots;
+	// ,   
+	std::vector<uint16_t> _releasedGenes;
+	int _blocksCountX;
+	int _blocksCountY;
+	std::vector<BlockContext> _blocks;
+	std::unique_ptr<ThreadPool> _threadPool;
+	//      ,     
+	Vector2i _followedTilePos;
+	//       .        
+	ptrdiff_t _directionOffsets[DIRECTIONS_COUNT];
 
 	//        
 	size_t getTileIndex(int x, int y);
-
-	//   
-	void processTile(int x, int y);
-
-	//   
-	sf::Color getTileColor(int x, int y);
+	//         
+	size_t getWrappedTileIndex(int x, int y);
+
+	//       
+	void setTileAlive(size_t index, bool isAlive);
+	//         
+	void markTileChanged(size_t index);
+	void markGeneChanged(uint16_t geneIndex);
+	//          begin  end,   end
+	template<typename Function>
+	void forEachAliveTile(size_t begin, size_t end, Function function);
+
+	//     
+	void processBlock(int blockX, int blockY);
+
+	//   .        ,
+	//      
+	template<bool IsBorder>
+	void processTile(int x, int y, BlockContext& context);
+
+	//           
+	void addTileStats(size_t index, BlockContext& context);
+	void removeTileStats(size_t index, BlockContext& context);
+
+	//       
+	template<bool IsBorder>
+	size_t getNeighbourIndex(size_t index, int x, int y, uint8_t direction);
+
+	//    
+	void applyMutations(BlockContext& context);
+
+	//     .      
+	void removeGeneReference(uint16_t geneIndex, BlockContext& context);
+	//  ,       
+	void releaseUnusedGenes(int phaseX, int phaseY);
+	//     
+	void releaseGene(uint16_t geneIndex);
 };
\ No newline at end of file
@@ -0,0 +1,67 @@
+#include "Gene.h"
+#include "TileStorage.h"
+#include "Trace.h"
+#include "World.h"
+#include "WorldFrame.h"
+
+void WorldFrame::capture(World& world)
+{
+	TraceScope traceScope("Frame capture");
+	TileStorage& tiles = *world._tiles;
+	size_t count = tiles.getCount();
+	size_t chunksCount = world._aliveMaskSize;
+
+	width = world._width;
+	height = world._height;
+	stepsCount = world._stepCounter;
+	energyMaximum = world._maxEnergy;
+	selectedTilePos = world.selectedTilePos;
+	geneColorsEpoch = world._geneColorsEpoch;
+
+	//    
+	bool isFull = _capturedEpoch == 0 || energy.size() != count;
+	if (isFull) {
+		energy.resize(count);
+		geneIndex.resize(count);
+		isPredator.resize(count);
+		chunkEpochs.resize(chunksCount);
+		chunkGroupEpochs.resize((chunksCount + CHUNK_GROUP_SIZE - 1) / CHUNK_GROUP_SIZE);
+	}
+	uint32_t capturedEpoch = _capturedEpoch;
+	epoch = world.beginChangeEpoch();
+	_capturedEpoch = epoch;
+
+	for (size_t chunk = 0; chunk < chunksCount; chunk++) {
+		uint32_t chunkEpoch = world._tileChangeStamps[chunk].load(std::memory_order_relaxed);
+		chunkEpochs[chunk] = chunkEpoch;
+		uint32_t& groupEpoch = chunkGroupEpochs[chunk / CHUNK_GROUP_SIZE];
+		if (chunk % CHUNK_GROUP_SIZE == 0 || chunkEpoch > groupEpoch)
+			groupEpoch = chunkEpoch;
+		if (!isFull && chunkEpoch <= capturedEpoch)
+			continue;
+
+		size_t begin = chunk * CHUNK_SIZE;
+		size_t end = begin + CHUNK_SIZE < count ? begin + CHUNK_SIZE : count;
+		for (size_t i = begin; i < end; i++) {
+			energy[i] = tiles.energy[i];
+			geneIndex[i] = tiles.geneIndex[i];
+			isPredator[i] = tiles.eatenFoodCount[i] > tiles.photosynthCount[i];
+		}
+	}
+
+	//     i    i - 1  
+	geneColors.resize(static_cast<size_t>(world._genesCount) + 1);
+	geneColors[0] = Color(0, 0, 0);
+	for (uint32_t i = 1; i <= world._genesCount; i++) {
+		if (!isFull && world._geneChangeStamps[i - 1] <= capturedEpoch)
+			continue;
+		Gene* gene = world.getGene(static_cast<uint16_t>(i));
+		geneColors[i] = gene != nullptr ? gene->color : Color(0, 0, 0);
+	}
+}
+
+bool WorldFrame::hasSelectedTile()
+{
+	return selectedTilePos.x >= 0 && selectedTilePos.y >= 0 &&
+		selectedTilePos.x < width && selectedTilePos.y < height;
+}
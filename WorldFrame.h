@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include "Color.h"
+#include "Vector2.h"
+
+class World;
+
+//   ,   .      ,
+//     ,   
+class WorldFrame
+{
+public:
+	//   ,     (    )
+	static const size_t CHUNK_SIZE = 64;
+
+	int width = 0;
+	int height = 0;
+	uint32_t stepsCount = 0;
+	float energyMaximum = 0.0f;
+	Vector2i selectedTilePos = Vector2i(-1, -1);
+
+	//     
+	std::vector<float> energy;
+	std::vector<uint16_t> geneIndex;
+	//    ,   
+	std::vector<uint8_t> isPredator;
+	//     .     
+	std::vector<Color> geneColors;
+
+	//   ,    (. World::beginChangeEpoch),
+	//       64 .     
+	//     
+	uint32_t epoch = 0;
+	std::vector<uint32_t> chunkEpochs;
+	//     CHUNK_GROUP_SIZE  ,     
+	static const size_t CHUNK_GROUP_SIZE = 64;
+	std::vector<uint32_t> chunkGroupEpochs;
+	//      
+	uint32_t geneColorsEpoch = 0;
+
+	//   .   ,    
+	//   ,        
+	void capture(World& world);
+	bool hasSelectedTile();
+
+private:
+	//      . 0 -    
+	uint32_t _capturedEpoch = 0;
+};
@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <math.h>
+#include <vector>
+#include "Config.h"
+#include "World.h"
+#include "WorldFrame.h"
+#include "WorldRenderer.h"
+
+WorldRenderer::WorldRenderer(World& world) : _world(world)
+{
+	cameraCenter = sf::Vector2f(world.getWidth() * 0.5f, world.getHeight() * 0.5f);
+	displayMode = DISPLAY_MODE_LIFE_FORMS;
+}
+
+void WorldRenderer::selectTile(sf::Vector2f screenPos, sf::Vector2f screenSize)
+{
+	float tileSize = getTileSize();
+
+	sf::Vector2f tilePos = cameraCenter - (screenSize * 0.5f - screenPos) / tileSize;
+
+	_world.selectedTilePos.x = static_cast<int>(tilePos.x);
+	_world.selectedTilePos.y = static_cast<int>(tilePos.y);
+}
+
+void WorldRenderer::render(sf::RenderTarget& renderTarget, WorldFrame& frame)
+{
+	float tileSize = getTileSize();
+
+	//      .    ,
+	//     ,       
+	int level = 0;
+	float cellSize = tileSize;
+	while (cellSize < 1.0f && (1 << level) < std::max(frame.width, frame.height)) {
+		cellSize *= 2.0f;
+		level++;
+	}
+
+	auto cameraPos = cameraCenter * tileSize;
+	auto halfSize = sf::Vector2f(renderTarget.getSize()) * 0.5f;
+	auto leftTop = cameraPos - halfSize;
+	auto offset = sf::Vector2f(leftTop.x - floorf(leftTop.x), leftTop.y - floorf(leftTop.y));
+	auto leftTopCell = sf::Vector2i(static_cast<int>(leftTop.x / cellSize), static_cast<int>(leftTop.y / cellSize));
+
+	//   
+	int countX = static_cast<int>((renderTarget.getSize().x - 1) / cellSize) + 2;
+	int countY = static_cast<int>((renderTarget.getSize().y - 1) / cellSize) + 2;
+
+	//  ,     
+	int startX = std::max(0, leftTopCell.x);
+	int endX = std::min(leftTopCell.x + countX, DisplayBuffer::getLevelSize(frame.width, level));
+	int startY = std::max(0, leftTopCell.y);
+	int endY = std::min(leftTopCell.y + countY, DisplayBuffer::getLevelSize(frame.height, level));
+
+	//     .          .
+	//      ,        
+	int width = std::max(0, endX - startX);
+	int height = std::max(0, endY - startY);
+	if (width > 0 && height > 0) {
+		sf::Vector2u textureSize = _tilesTexture.getSize();
+		if (textureSize.x < static_cast<unsigned>(width) || textureSize.y < static_cast<unsigned>(height)) {
+			_tilesTexture.create(std::max(textureSize.x, static_cast<unsigned>(width)), std::max(textureSize.y, static_cast<unsigned>(height)));
+			_tilesTexture.setSmooth(false);
+			_displayBuffer.invalidate();
+		}
+
+		_displayBuffer.update(frame, displayMode, level, startX, startY, width, height);
+		int dirtyTop = _displayBuffer.getDirtyTop();
+		int dirtyBottom = _displayBuffer.getDirtyBottom();
+		if (dirtyTop < dirtyBottom)
+			_tilesTexture.update(_displayBuffer.getPixels() + static_cast<size_t>(dirtyTop) * width * 4, width, dirtyBottom - dirtyTop, 0, dirtyTop);
+
+		sf::Sprite tilesSprite(_tilesTexture);
+		tilesSprite.setTextureRect(sf::IntRect(0, 0, width, height));
+		tilesSprite.setPosition(sf::Vector2f((float)startX, (float)startY) * cellSize - offset - cameraPos + halfSize);
+		tilesSprite.setScale(cellSize, cellSize);
+		renderTarget.draw(tilesSprite);
+	}
+
+	//  .       
+	if (isGridEnabled && level == 0 && startX < endX && startY < endY) {
+		//           ,
+		//           
+		int gridTextureSize = std::max(1, static_cast<int>(tileSize));
+		if (gridTextureSize != _gridTextureSize)
+			updateGridTexture(gridTextureSize);
+
+		sf::Sprite gridSprite(_gridTexture);
+		gridSprite.setTextureRect(sf::IntRect(0, 0, (endX - startX) * gridTextureSize, (endY - startY) * gridTextureSize));
+		gridSprite.setPosition(sf::Vector2f((float)startX, (float)startY) * tileSize - offset - cameraPos + halfSize);
+		gridSprite.setScale(tileSize / gridTextureSize, tileSize / gridTextureSize);
+		renderTarget.draw(gridSprite);
+	}
+
+	static sf::Vertex selectedTileVertices[] = {
+		sf::Vertex(sf::Vector2f(), toSfColor(SELECTION_COLOR)),
+		sf::Vertex(sf::Vector2f(), toSfColor(SELECTION_COLOR)),
+		sf::Vertex(sf::Vector2f(), toSfColor(SELECTION_COLOR)),
+		sf::Vertex(sf::Vector2f(), toSfColor(SELECTION_COLOR)),
+		sf::Vertex(sf::Vector2f(), toSfColor(SELECTION_COLOR))
+	};
+	if (frame.hasSelectedTile()) {
+		//         
+		sf::Vector2f tilePos = sf::Vector2f(sf::Vector2i(frame.selectedTilePos.x, frame.selectedTilePos.y)) * tileSize - offset - cameraPos + halfSize;
+		float selectionSize = std::max(tileSize, 1.0f);
+		selectedTileVertices[0].position = tilePos;
+		selectedTileVertices[1].position = tilePos + sf::Vector2f(selectionSize, 0.0f);
+		selectedTileVertices[2].position = tilePos + sf::Vector2f(selectionSize, selectionSize);
+		selectedTileVertices[3].position = tilePos + sf::Vector2f(0.0f, selectionSize);
+		selectedTileVertices[4].position = tilePos;
+
+		//    
+		renderTarget.draw(selectedTileVertices, 5, sf::PrimitiveType::LinesStrip);
+	}
+}
+
+void WorldRenderer::updateGridTexture(int size)
+{
+	//   ,        
+	std::vector<sf::Color> pixels(static_cast<size_t>(size) * size, sf::Color::Transparent);
+	sf::Color gridColor = toSfColor(GRID_COLOR);
+	for (int i = 0; i < size; i++) {
+		pixels[i] = gridColor;
+		pixels[static_cast<size_t>(i) * size + size - 1] = gridColor;
+	}
+
+	_gridTexture.create(size, size);
+	_gridTexture.update(reinterpret_cast<const sf::Uint8*>(pixels.data()));
+	_gridTexture.setRepeated(true);
+	_gridTextureSize = size;
+}
+
+float WorldRenderer::getTileSize()
+{
+	return TILE_SIZE * cameraZoom;
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include "Color.h"
+#include "DisplayBuffer.h"
+
+class World;
+class WorldFrame;
+
+//       SFML
+inline sf::Color toSfColor(Color color)
+{
+	return sf::Color(color.r, color.g, color.b, color.a);
+}
+
+//     .   World,       SFML
+class WorldRenderer
+{
+public:
+	WorldRenderer(World& world);
+
+	//    
+	sf::Vector2f cameraCenter;
+	float cameraZoom = 1.0f;
+
+	//   
+	bool isGridEnabled = true;
+
+	//    
+	DisplayMode displayMode;
+
+	void selectTile(sf::Vector2f screenPos, sf::Vector2f screenSize);
+	//   .            
+	void render(sf::RenderTarget&, WorldFrame& frame);
+
+	float getTileSize();
+
+private:
+	World& _world;
+	//          
+	DisplayBuffer _displayBuffer;
+	sf::Texture _tilesTexture;
+	//         ,
+	//       ,     
+	sf::Texture _gridTexture;
+	int _gridTextureSize = 0;
+
+	//       size 
+	void updateGridTexture(int size);
+};